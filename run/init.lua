@@ -1,4 +1,6 @@
-dofile(insight.dir .. "/lua/bindings/azerty.lua")
+if insight.graphicEngine then
+    dofile(insight.dir .. "/lua/bindings/azerty.lua")
+end
 
 demos = require("demos/allDemos")
 
@@ -0,0 +1,69 @@
+-- Benchmark comparing the step time of capsule & cylinder limbs.
+--
+-- Usage (from the Lua console): require("benchmarks/capsules")
+--
+-- Each shape type is simulated in its own world (see insight:newWorld()): a grid of limbs
+-- (with the dimensions of the thighs of the android) fall in a heap on a static plane.
+
+local newShape = insight.world.newShape
+
+-- Number of limbs along each horizontal axis of the grid.
+local GRID_SIZE = 10
+-- Number of layers of the grid.
+local LAYER_COUNT = 4
+-- Number of simulation steps (1/60 s each).
+local STEP_COUNT = 600
+-- Dimensions of a limb (see THIGH_HALF_EXTENTS in robots/androidInfo.lua).
+local HALF_EXTENTS = {0.035, 0.175, 0.035}
+-- Density of the limbs (kg/m^3).
+local DENSITY = 1500
+
+-- Creates the shape of a limb.
+--
+-- Arguments:
+-- * shapeType: "Cylinder" or "Capsule"
+-- Returns: the shape of the limb (the capsule has the same radius & total length as the cylinder).
+local function newLimb(shapeType)
+    if shapeType == "Capsule" then
+        local radius = HALF_EXTENTS[1]
+        return newShape{type= "Capsule", params= {density= DENSITY, radius= radius, halfHeight= HALF_EXTENTS[2]-radius}}
+    else
+        return newShape{type= "Cylinder", params= {density= DENSITY, halfExtents= HALF_EXTENTS}}
+    end
+end
+
+-- Runs the benchmark for a shape type.
+--
+-- Arguments:
+-- * shapeType: shape type of the limbs ("Cylinder" or "Capsule")
+-- Returns: the CPU time (s) spent stepping the world.
+local function run(shapeType)
+    local shape = newLimb(shapeType)
+    local scene = insight:newWorld()
+    scene.world:newBody{shape= {type= "StaticPlane", params= {normal= {0,1,0}, offset= 0}}}
+    local spacing = 2*HALF_EXTENTS[2] + 0.05
+    for layer=1,LAYER_COUNT do
+        -- Alternate horizontal directions, so that the layers cross each other.
+        local rotation = {axis= {1,0,0}, angle= math.pi/2}
+        if layer % 2 == 0 then
+            rotation = {axis= {0,0,1}, angle= math.pi/2}
+        end
+        for i=1,GRID_SIZE do
+            for j=1,GRID_SIZE do
+                local body = scene.world:newBody{shape= shape}
+                body:setPosition({i*spacing, 0.5*layer, j*spacing})
+                body:setRotation(rotation)
+            end
+        end
+    end
+    local start = os.clock()
+    scene:step(STEP_COUNT)
+    local result = os.clock() - start
+    insight:removeWorld(scene)
+    return result
+end
+
+print(string.format("%d limbs, %d steps:", GRID_SIZE*GRID_SIZE*LAYER_COUNT, STEP_COUNT))
+for _,shapeType in ipairs({"Cylinder", "Capsule"}) do
+    print(string.format("- %s: %.3f s", shapeType, run(shapeType)))
+end
@@ -40,10 +40,14 @@ end
 -- Arguments:
 -- * position: coordinates where the camera will be placed.
 -- * lookAt: coordinates of a point that will be centered in the view.
+--
+-- Does nothing in headless mode.
 function Demo.placeCamera(position, lookAt)
-    local camera = insight.graphicEngine.camera
-    camera:setPosition(position)
-    camera:lookAt(lookAt)
+    if insight.graphicEngine then
+        local camera = insight.graphicEngine.camera
+        camera:setPosition(position)
+        camera:lookAt(lookAt)
+    end
 end
 
 function Demo.__call(self, ...)
@@ -18,7 +18,7 @@ function demoShapes.exec()
 
     -- List of object added into the world by this script.
 
-    print("Currently 5 different basic shapes can be inserted via Lua.")
+    print("Currently 6 different basic shapes can be inserted via Lua.")
     objects= {}
 
     print("1 - StaticPlane shape (cannot move), used for the ground")
@@ -85,11 +85,28 @@ function demoShapes.exec()
                     { 0.5,-0.2,-0.5},
                     { 0, 0.4, 0},
                 },
+                -- optional: maxVertices= 64, simplifies the hull to this number of vertices
+                -- (shape.simplificationError gives the resulting error).
             },
         },
     })
     objects.pyramid:setPosition({-2,0.2,0})
 
+    print("6 - Capsule shape (cheaper collisions than a cylinder)")
+    -- In default orientations, the capsule is Y-axis aligned.
+    objects.capsule = world:newBody({
+        shape= {
+            type= "Capsule",
+            params= {
+                radius= 0.2,
+                halfHeight= 0.3, -- half length of the cylindric part (total length: 1m).
+                density= 1000,
+                -- mass can be specified instead of density.
+            },
+        },
+    })
+    objects.capsule:setPosition({2,1.5,0})
+
     print("")
     print("It is possible to combine the basic shapes to make concave objects (here a table)")
     objects.table = world:newBody({
@@ -288,6 +288,8 @@ local androidInfo= insight.newRobotInfo{
     },
     -- name of the base part (this is the position read & written by Lua methods)
     basePart= "Torso",
+    -- parts linked by a joint never touch (the joint margins keep them apart).
+    adjacentCollisions= false,
     -- list of joints indexed by their names.
     joints= {
         Neck= {info= JOINTS_INFO.Neck, convexPart= "Torso", concavePart= "Head"},
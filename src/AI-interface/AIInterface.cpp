@@ -25,6 +25,12 @@ AIInterface::AIInterface() = default;
 
 AIInterface::~AIInterface() = default;
 
+void AIInterface::setActionObserver(ActionObserver* observer) {
+    for (auto& pair : actions) {
+        pair.second->setObserver(observer);
+    }
+}
+
 int AIInterface::luaIndex(const std::string& memberName, LuaStateView& state) {
     int result = 1;
     if (memberName=="senses") {
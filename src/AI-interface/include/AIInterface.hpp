@@ -49,6 +49,13 @@ public:
         return senses;
     }
 
+    /**
+     * Sets the object informed of the values set into the action signals of this interface.
+     *
+     * @param observer The new observer (can be null).
+     */
+    void setActionObserver(ActionObserver* observer);
+
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
 private:
     /** Map: action name to signal. */
@@ -45,8 +45,12 @@ namespace details {
         /**
          * DefaultAction constructor.
          * @param getter Function used to set the value of this action signal.
+         * @param waker Function waking up the bodies driven by this signal (can be empty).
          */
-        DefaultAction(std::function<void(const T&)>&& setter) : setter(setter) {
+        DefaultAction(std::function<void(const T&)>&& setter, std::function<void()>&& waker = nullptr) :
+            setter(setter),
+            waker(waker)
+        {
 
         }
 
@@ -56,14 +60,31 @@ namespace details {
          */
         void set(const T& value) const {
             setter(value);
+            if (observer != nullptr) {
+                observer->onAction(*this, value);
+            }
         };
 
+        /**
+         * Wakes up the bodies driven by this action signal.
+         *
+         * Setting a value does not always wake up sleeping bodies (see Joint). This
+         * method must be called when the output is changed on purpose (new command,
+         * new target of a control loop...), so that the change takes effect.
+         */
+        void wake() const {
+            if (waker) {
+                waker();
+            }
+        }
+
         int luaIndex(const std::string& memberName, LuaStateView& state) override {
             using Method = LuaMethod<DefaultAction>;
             int result = 1;
             if (memberName=="set") {
                 state.push<Method>([](DefaultAction& object, LuaStateView& state) -> int {
-                    object.setter(state.get<T>(2));
+                    object.set(state.get<T>(2));
+                    object.wake();
                     return 0;
                 });
             } else {
@@ -74,6 +95,8 @@ namespace details {
     private:
         /** Function used to set the value of this signal. */
         std::function<void(const T&)> setter;
+        /** Function used to wake up the bodies driven by this signal (can be empty). */
+        std::function<void()> waker;
     };
 }
 
@@ -0,0 +1,48 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ACTIONOBSERVER_HPP
+#define ACTIONOBSERVER_HPP
+
+#include "btBulletDynamicsCommon.h"
+
+class ActionSignal;
+
+/** Interface to be informed of the values set into action signals. */
+class ActionObserver {
+public:
+    /**
+     * Event triggered when a float action signal is set.
+     *
+     * @param[in] action Action signal modified.
+     * @param[in] value New value of the signal.
+     */
+    virtual void onAction(const ActionSignal& action, float value) = 0;
+
+    /**
+     * Event triggered when a btVector3 action signal is set.
+     *
+     * @param[in] action Action signal modified.
+     * @param[in] value New value of the signal.
+     */
+    virtual void onAction(const ActionSignal& action, const btVector3& value) = 0;
+
+    virtual ~ActionObserver() = default;
+};
+
+#endif /* ACTIONOBSERVER_HPP */
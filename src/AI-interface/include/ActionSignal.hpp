@@ -19,6 +19,7 @@
 #ifndef ACTIONSIGNAL_HPP
 #define ACTIONSIGNAL_HPP
 
+#include "ActionObserver.hpp"
 #include "lua/types/LuaVirtualClass.hpp"
 
 class ActionVisitor;
@@ -31,6 +32,11 @@ class ActionVisitor;
  */
 class ActionSignal : public LuaVirtualClass {
 public:
+    /** Creates a new action signal, without observer. */
+    ActionSignal() : observer(nullptr) {
+
+    }
+
     virtual ~ActionSignal() = default;
 
     /** Apply some algorithm to this object (visitor pattern).
@@ -38,6 +44,18 @@ public:
      * @param visitor Algorithm to apply on this object.
      */
     virtual void apply(ActionVisitor& visitor) = 0;
+
+    /**
+     * Sets the object informed of the new values of this signal.
+     *
+     * @param value The new observer (can be null).
+     */
+    void setObserver(ActionObserver* value) {
+        observer = value;
+    }
+protected:
+    /** Object informed of the new values of this signal (can be null). */
+    ActionObserver* observer;
 };
 
 #endif /* ACTIONSIGNAL_HPP */
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 
+#include "BinaryStream.hpp"
 #include "CylindricJointFeedbackLoop.hpp"
 #include "lua/bindings/FundamentalTypes.hpp"
 #include "lua/types/LuaMethod.hpp"
@@ -41,6 +42,16 @@ void CylindricJointFeedbackLoop::stepSimulation() {
     previousAngle = newAngle;
 }
 
+void CylindricJointFeedbackLoop::saveState(std::ostream& stream) const {
+    writeBinary(stream, targetAngle);
+    writeBinary(stream, previousAngle);
+}
+
+void CylindricJointFeedbackLoop::loadState(std::istream& stream) {
+    targetAngle = readBinary<float>(stream);
+    previousAngle = readBinary<float>(stream);
+}
+
 int CylindricJointFeedbackLoop::luaIndex(const std::string& memberName, LuaStateView& state) {
     using Method = LuaMethod<CylindricJointFeedbackLoop>;
     int result = 1;
@@ -48,8 +59,7 @@ int CylindricJointFeedbackLoop::luaIndex(const std::string& memberName, LuaState
         state.push<float>(targetAngle);
     } else if (memberName == "setTarget") {
         state.push<Method>([](CylindricJointFeedbackLoop& object, LuaStateView& state) -> int {
-            auto value = state.get<float>(2);
-            object.targetAngle = std::clamp(value, -SIMD_PI, SIMD_PI);
+            object.setTarget(state.get<float>(2));
             return 0;
         });
     } else {
@@ -57,3 +67,11 @@ int CylindricJointFeedbackLoop::luaIndex(const std::string& memberName, LuaState
     }
     return result;
 }
+
+void CylindricJointFeedbackLoop::setTarget(float angle) {
+    float newTarget = std::clamp(angle, -SIMD_PI, SIMD_PI);
+    if (newTarget != targetAngle) {
+        targetAngle = newTarget;
+        outputMotorTorque.wake();
+    }
+}
@@ -16,8 +16,11 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
 
+#include "BinaryStream.hpp"
 #include "CylindricJointFeedbackLoop.hpp"
 #include "FeedbackAI.hpp"
 #include "FeedbackLoop.hpp"
@@ -133,6 +136,38 @@ int FeedbackAI::luaIndex(const std::string& memberName, LuaStateView& state) {
     return result;
 }
 
+void FeedbackAI::saveState(std::ostream& stream) const {
+    // Sorted by name: the snapshot must not depend on the hash map ordering.
+    std::vector<const std::string*> names;
+    names.reserve(loops.size());
+    for (auto& pair : loops) {
+        names.push_back(&pair.first);
+    }
+    std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b) {
+        return *a < *b;
+    });
+    writeBinary<std::uint32_t>(stream, names.size());
+    for (auto name : names) {
+        writeBinaryString(stream, *name);
+        loops.at(*name)->saveState(stream);
+    }
+}
+
+void FeedbackAI::loadState(std::istream& stream) {
+    auto count = readBinary<std::uint32_t>(stream);
+    if (count != loops.size()) {
+        throw std::runtime_error("FeedbackAI: the saved state does not match the feedback loops of this AI.");
+    }
+    for (std::uint32_t i = 0; i < count; i++) {
+        std::string name = readBinaryString(stream);
+        auto it = loops.find(name);
+        if (it == loops.end()) {
+            throw std::runtime_error("FeedbackAI: unknown feedback loop in saved state: " + name);
+        }
+        it->second->loadState(stream);
+    }
+}
+
 void FeedbackAI::stepSimulation() {
     for (auto& pair : loops) {
         pair.second->stepSimulation();
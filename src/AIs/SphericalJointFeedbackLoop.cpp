@@ -16,6 +16,7 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "BinaryStream.hpp"
 #include "SphericalJointFeedbackLoop.hpp"
 
 SphericalJointFeedbackLoop::SphericalJointFeedbackLoop(const Sense<btQuaternion>& sense, Action<btVector3>& action) :
@@ -53,6 +54,40 @@ void SphericalJointFeedbackLoop::stepSimulation() {
     previousRotation = newRotation;
 }
 
+/**
+ * Writes a quaternion in a binary stream.
+ * @param stream Output stream.
+ * @param quaternion Quaternion to write.
+ */
+static void writeQuaternion(std::ostream& stream, const btQuaternion& quaternion) {
+    for (int i = 0; i < 4; i++) {
+        writeBinary<btScalar>(stream, quaternion[i]);
+    }
+}
+
+/**
+ * Reads a quaternion written by writeQuaternion().
+ * @param stream Input stream.
+ * @return The quaternion read.
+ */
+static btQuaternion readQuaternion(std::istream& stream) {
+    btQuaternion result;
+    for (int i = 0; i < 4; i++) {
+        result[i] = readBinary<btScalar>(stream);
+    }
+    return result;
+}
+
+void SphericalJointFeedbackLoop::saveState(std::ostream& stream) const {
+    writeQuaternion(stream, targetRotation);
+    writeQuaternion(stream, previousRotation);
+}
+
+void SphericalJointFeedbackLoop::loadState(std::istream& stream) {
+    targetRotation = readQuaternion(stream);
+    previousRotation = readQuaternion(stream);
+}
+
 int SphericalJointFeedbackLoop::luaIndex(const std::string& memberName, LuaStateView& state) {
     using Method = LuaMethod<SphericalJointFeedbackLoop>;
     int result = 1;
@@ -60,9 +95,7 @@ int SphericalJointFeedbackLoop::luaIndex(const std::string& memberName, LuaState
         state.push<btQuaternion>(targetRotation);
     } else if (memberName == "setTarget") {
         state.push<Method>([](SphericalJointFeedbackLoop& object, LuaStateView& state) -> int {
-            btQuaternion newTarget = state.get<btQuaternion>(2);
-            newTarget.normalize();
-            object.targetRotation = newTarget;
+            object.setTarget(state.get<btQuaternion>(2));
             return 0;
         });
     } else {
@@ -70,3 +103,11 @@ int SphericalJointFeedbackLoop::luaIndex(const std::string& memberName, LuaState
     }
     return result;
 }
+
+void SphericalJointFeedbackLoop::setTarget(const btQuaternion& rotation) {
+    btQuaternion newTarget = rotation.normalized();
+    if (newTarget != targetRotation) {
+        targetRotation = newTarget;
+        outputMotorTorque.wake();
+    }
+}
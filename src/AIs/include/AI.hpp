@@ -19,7 +19,9 @@
 #ifndef AI_HPP
 #define AI_HPP
 
+#include <istream>
 #include <memory>
+#include <ostream>
 
 #include "AIInterface.hpp"
 #include "lua/types/LuaTable.hpp"
@@ -46,6 +48,24 @@ public:
      * the actions signals values.
      */
     virtual void stepSimulation() = 0;
+
+    /**
+     * Writes the internal state of this AI (used by simulation snapshots).
+     *
+     * @param stream Binary output stream.
+     */
+    virtual void saveState(std::ostream& stream) const {
+
+    }
+
+    /**
+     * Reads the state written by saveState().
+     *
+     * @param stream Binary input stream.
+     */
+    virtual void loadState(std::istream& stream) {
+
+    }
 protected:
     /** Interface (sense & action signals) of the body controlled by this AI. */
     AIInterface& interface;
@@ -37,7 +37,20 @@ public:
 
     void stepSimulation() override;
 
+    void saveState(std::ostream& stream) const override;
+
+    void loadState(std::istream& stream) override;
+
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
+
+    /**
+     * Sets the target angle of this loop.
+     *
+     * A new target wakes up the body parts of the joint.
+     *
+     * @param angle The new target angle (clamped into [-PI;PI]).
+     */
+    void setTarget(float angle);
 private:
     /** Relative orientation of the two parts of the joint. */
     const Sense<float>& inputRotation;
@@ -39,6 +39,19 @@ public:
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
 
     void stepSimulation() override;
+
+    void saveState(std::ostream& stream) const override;
+
+    void loadState(std::istream& stream) override;
+
+    /**
+     * Gets the feedback loop controlling a joint.
+     * @param jointName Name of the joint.
+     * @return The feedback loop of this joint.
+     */
+    FeedbackLoop& getLoop(const std::string& jointName) {
+        return *loops.at(jointName);
+    }
 private:
     /** List of feedback loops owned by this AI. */
     std::unordered_map<std::string, std::unique_ptr<FeedbackLoop>> loops;
@@ -19,6 +19,9 @@
 #ifndef FEEDBACKLOOP_HPP
 #define FEEDBACKLOOP_HPP
 
+#include <istream>
+#include <ostream>
+
 #include "lua/types/LuaVirtualClass.hpp"
 
 /** Single feedback loop, controlling a specific joint. */
@@ -32,6 +35,20 @@ public:
      * This method is called at regular time interval by the simulation.
      */
     virtual void stepSimulation() = 0;
+
+    /**
+     * Writes the internal state of this loop (target, previous input...).
+     *
+     * @param stream Binary output stream.
+     */
+    virtual void saveState(std::ostream& stream) const = 0;
+
+    /**
+     * Reads the state written by saveState().
+     *
+     * @param stream Binary input stream.
+     */
+    virtual void loadState(std::istream& stream) = 0;
 };
 
 #endif /* FEEDBACKLOOP_HPP */
@@ -39,7 +39,20 @@ public:
 
     void stepSimulation() override;
 
+    void saveState(std::ostream& stream) const override;
+
+    void loadState(std::istream& stream) override;
+
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
+
+    /**
+     * Sets the target rotation of this loop.
+     *
+     * A new target wakes up the body parts of the joint.
+     *
+     * @param rotation The new target rotation (normalized by this method).
+     */
+    void setTarget(const btQuaternion& rotation);
 private:
     /** Relative orientation of the two parts of the joint. */
     const Sense<btQuaternion>& inputRotation;
@@ -0,0 +1,134 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <catch.hpp>
+
+#include "CuboidShape.hpp"
+#include "CylindricJointFeedbackLoop.hpp"
+#include "CylindricJointInfo.hpp"
+#include "FeedbackAI.hpp"
+#include "RobotBody.hpp"
+#include "Sense.hpp"
+#include "units/Scalar.hpp"
+#include "units/SI.hpp"
+#include "units/Transform.hpp"
+#include "units/Vector3.hpp"
+#include "World.hpp"
+
+/** Duration of a simulation tick (s). */
+static const double TICK_DURATION = 1.0 / 60.0;
+
+/** Steps the world, then the AI if the robot is awake (same as the Scene). */
+static void stepTick(World& world, const RobotBody& robot, FeedbackAI& ai) {
+    world.stepSimulation(TICK_DURATION);
+    if (!robot.isSleeping()) {
+        ai.stepSimulation();
+    }
+}
+
+/** Creates a robot made of two cuboids linked by a cylindric joint named "hinge". */
+static std::shared_ptr<const RobotBody::ConstructionInfo> makeHingeRobotInfo() {
+    const Vector3<SI::Length> halfExtents(0.1, 0.1, 0.1);
+    std::unordered_map<std::string, std::shared_ptr<Shape>> parts = {
+        {"base", CuboidShape::makeShared(Scalar<SI::Mass>(1), halfExtents)},
+        {"arm", CuboidShape::makeShared(Scalar<SI::Mass>(1), halfExtents)},
+    };
+    // The hinge is 5cm away from both cuboids.
+    const Transform<SI::Length> cylinderTransform(btQuaternion::getIdentity(), btVector3(0, -0.15, 0));
+    const Transform<SI::Length> socketTransform(btQuaternion::getIdentity(), btVector3(0, 0.15, 0));
+    auto hingeInfo = std::make_shared<CylindricJointInfo>(
+        Scalar<SI::Density>(1000),                  // density
+        cylinderTransform,                          // cylinderTransform
+        false,                                      // generateCylinder
+        socketTransform,                            // socketTransform
+        Scalar<SI::Length>(0.05),                   // radius
+        Scalar<SI::Length>(0.1),                    // length
+        Scalar<SI::Angle>(0),                       // startRotation
+        Scalar<SI::Angle>(-SIMD_HALF_PI),           // minAngle
+        Scalar<SI::Angle>(SIMD_HALF_PI),            // maxAngle
+        Scalar<SI::Torque>(1),                      // maxMotorTorque
+        Scalar<SI::AngularFrictionCoefficient>(0)   // frictionCoefficient
+    );
+    std::unordered_map<std::string, RobotBody::ConstructionInfo::JointInputData> joints = {
+        {"hinge", {hingeInfo, "arm", "base"}},
+    };
+    RobotBody::ConstructionInfo::CollisionFilter filter;
+    filter.adjacentCollisions = false;
+    return std::make_shared<RobotBody::ConstructionInfo>(parts, "base", joints, filter);
+}
+
+TEST_CASE("FeedbackAI of a sleeping robot") {
+    World world;
+    world.setGravity(Vector3<SI::Acceleration>(0, 0, 0));
+    RobotBody robot(world, makeHingeRobotInfo());
+    FeedbackAI ai(robot.getInterface());
+    auto& loop = dynamic_cast<CylindricJointFeedbackLoop&>(ai.getLoop("hinge"));
+    auto& rotation = dynamic_cast<Sense<float>&>(*robot.getInterface().getSenses().at("hinge.rotation"));
+
+    // Nothing moves: the robot must fall asleep once the deactivation time (2s) has elapsed.
+    const int MAX_SLEEP_TICKS = 600;
+    int ticks = 0;
+    while (!robot.isSleeping() && ticks < MAX_SLEEP_TICKS) {
+        stepTick(world, robot, ai);
+        ticks++;
+    }
+    REQUIRE(robot.isSleeping());
+
+    SECTION("Stays asleep without new target") {
+        for (int i = 0; i < 60; i++) {
+            stepTick(world, robot, ai);
+        }
+        REQUIRE(robot.isSleeping());
+    }
+
+    SECTION("Wakes up and moves on a new target") {
+        const float startAngle = rotation.get();
+        loop.setTarget(1.0f);
+        stepTick(world, robot, ai);
+        REQUIRE_FALSE(robot.isSleeping());
+        for (int i = 0; i < 60; i++) {
+            stepTick(world, robot, ai);
+        }
+        REQUIRE(std::abs(rotation.get() - startAngle) > 0.1f);
+    }
+
+    SECTION("Wakes up and moves on a small new target") {
+        // The P-torque of this target (0.2 * 0.02) is far below the wake threshold of the
+        // motor (2% of 1 N.m): only the explicit wake up of setTarget() can move the joint.
+        const float startAngle = rotation.get();
+        const float delta = 0.02f;
+        loop.setTarget(startAngle + delta);
+        stepTick(world, robot, ai);
+        REQUIRE_FALSE(robot.isSleeping());
+        for (int i = 0; i < 30; i++) {
+            stepTick(world, robot, ai);
+        }
+        REQUIRE(rotation.get() - startAngle > 0.25f * delta);
+    }
+
+    SECTION("Stays asleep on the same target") {
+        loop.setTarget(0.0f);
+        stepTick(world, robot, ai);
+        REQUIRE(robot.isSleeping());
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CommandQueue.hpp"
+
+CommandQueue::CommandQueue() :
+    head(new Node(nullptr))
+{
+    tail = head.load(std::memory_order_relaxed);
+}
+
+void CommandQueue::push(Command command) {
+    Node* node = new Node(std::move(command));
+    Node* previous = head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+bool CommandQueue::empty() const {
+    return tail->next.load(std::memory_order_acquire) == nullptr;
+}
+
+bool CommandQueue::runNext() {
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        return false;
+    }
+    Command command = std::move(next->command);
+    delete tail;
+    tail = next;
+    command();
+    return true;
+}
+
+void CommandQueue::runAll() {
+    while (runNext()) {
+
+    }
+}
+
+CommandQueue::~CommandQueue() {
+    Node* current = tail;
+    while (current != nullptr) {
+        Node* next = current->next.load(std::memory_order_relaxed);
+        delete current;
+        current = next;
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameStats.hpp"
+#include "lua/bindings/FundamentalTypes.hpp"
+#include "lua/types/LuaNativeString.hpp"
+#include "lua/types/LuaTable.hpp"
+
+/**
+ * Pushes the summary of some statistics as a Lua table.
+ *
+ * @param[in] stats Statistics to push.
+ * @param state Lua state in which the table is pushed.
+ */
+static void pushSummary(const RollingStats& stats, LuaStateView& state) {
+    RollingStats::Summary summary = stats.getSummary();
+    LuaTable table(state, false);
+    table.set<LuaNativeString,double>("count", summary.count);
+    table.set<LuaNativeString,double>("min", summary.min);
+    table.set<LuaNativeString,double>("mean", summary.mean);
+    table.set<LuaNativeString,double>("p50", summary.p50);
+    table.set<LuaNativeString,double>("p99", summary.p99);
+    table.set<LuaNativeString,double>("max", summary.max);
+}
+
+FrameStats::FrameStats() :
+    droppedTime(0),
+    lostSubStepTime(0)
+{
+
+}
+
+int FrameStats::luaIndex(const std::string& memberName, LuaStateView& state) {
+    int result = 1;
+    if (memberName == "physics") {
+        pushSummary(physics, state);
+    } else if (memberName == "bullet") {
+        pushSummary(bullet, state);
+    } else if (memberName == "constraints") {
+        pushSummary(constraints, state);
+    } else if (memberName == "publish") {
+        pushSummary(publish, state);
+    } else if (memberName == "ai") {
+        pushSummary(ai, state);
+    } else if (memberName == "render") {
+        pushSummary(render, state);
+    } else if (memberName == "sleep") {
+        pushSummary(sleep, state);
+    } else if (memberName == "droppedTime") {
+        state.push<double>(droppedTime);
+    } else if (memberName == "lostSubStepTime") {
+        state.push<double>(lostSubStepTime);
+    } else {
+        result = 0;
+    }
+    return result;
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+
+#include "Recorder.hpp"
+
+Recorder::Recorder(const std::string& path) :
+    file(path, std::ios::binary | std::ios::trunc),
+    unflushedSteps(0)
+{
+    if (!file) {
+        std::string msg = "Cannot create record file: " + path;
+        throw std::runtime_error(msg);
+    }
+    file.write(MAGIC, sizeof(MAGIC));
+    write<std::uint8_t>(VERSION);
+    write<std::uint8_t>(sizeof(btScalar));
+}
+
+void Recorder::addRobot(std::uint32_t robotId, AIInterface& interface) {
+    for (auto& pair : interface.getActions()) {
+        std::uint32_t actionId = actionIds.size();
+        actionIds[pair.second] = actionId;
+        write(Event::defineAction);
+        write(actionId);
+        write(robotId);
+        writeString(pair.first);
+    }
+    interface.setActionObserver(this);
+}
+
+void Recorder::onCommand(const std::string& command) {
+    write(Event::command);
+    writeString(command);
+    file.flush();
+    unflushedSteps = 0;
+}
+
+void Recorder::onStep() {
+    write(Event::step);
+    unflushedSteps++;
+    if (unflushedSteps >= FLUSH_PERIOD) {
+        file.flush();
+        unflushedSteps = 0;
+    }
+}
+
+void Recorder::onAction(const ActionSignal& action, float value) {
+    write(Event::actionFloat);
+    write(getActionId(action));
+    write(value);
+}
+
+void Recorder::onAction(const ActionSignal& action, const btVector3& value) {
+    write(Event::actionVector);
+    write(getActionId(action));
+    write(value.x());
+    write(value.y());
+    write(value.z());
+}
+
+void Recorder::writeString(const std::string& value) {
+    write<std::uint32_t>(value.size());
+    file.write(value.data(), value.size());
+}
+
+std::uint32_t Recorder::getActionId(const ActionSignal& action) const {
+    auto it = actionIds.find(&action);
+    if (it == actionIds.end()) {
+        throw std::logic_error("Recorder: unknown action signal.");
+    }
+    return it->second;
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <stdexcept>
+
+#include "Recorder.hpp"
+#include "Replay.hpp"
+
+Replay::Replay(const std::string& path, Scene& scene, ShellInterpreter& shell) :
+    file(path, std::ios::binary),
+    scene(scene),
+    shell(shell),
+    stepCount(0)
+{
+    if (!file) {
+        std::string msg = "Cannot open record file: " + path;
+        throw std::runtime_error(msg);
+    }
+    char magic[sizeof(Recorder::MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, Recorder::MAGIC, sizeof(magic)) != 0) {
+        std::string msg = "Not a record file: " + path;
+        throw std::runtime_error(msg);
+    }
+    if (read<std::uint8_t>() != Recorder::VERSION) {
+        throw std::runtime_error("Replay: unsupported record version.");
+    }
+    if (read<std::uint8_t>() != sizeof(btScalar)) {
+        throw std::runtime_error("Replay: record made with a different precision of Bullet.");
+    }
+}
+
+bool Replay::next() {
+    using Event = Recorder::Event;
+    Event event;
+    file.read(reinterpret_cast<char*>(&event), sizeof(event));
+    if (!file) {
+        return false;
+    }
+    switch (event) {
+    case Event::command:
+        shell.execute(readString());
+        break;
+    case Event::step:
+        scene.stepPhysics();
+        stepCount++;
+        break;
+    case Event::defineAction:
+    {
+        std::uint32_t actionId = read<std::uint32_t>();
+        std::uint32_t robotId = read<std::uint32_t>();
+        std::string name = readString();
+        actions[actionId] = scene.getRobot(robotId).body->getInterface().getActions().at(name);
+        break;
+    }
+    case Event::actionFloat:
+    {
+        std::uint32_t actionId = read<std::uint32_t>();
+        float value = read<float>();
+        getAction<float>(actionId).set(value);
+        break;
+    }
+    case Event::actionVector:
+    {
+        std::uint32_t actionId = read<std::uint32_t>();
+        btScalar x = read<btScalar>();
+        btScalar y = read<btScalar>();
+        btScalar z = read<btScalar>();
+        getAction<btVector3>(actionId).set(btVector3(x, y, z));
+        break;
+    }
+    default:
+        throw std::runtime_error("Replay: unknown event type.");
+    }
+    return true;
+}
+
+std::string Replay::readString() {
+    std::uint32_t length = read<std::uint32_t>();
+    std::string result(length, '\0');
+    file.read(&result[0], length);
+    if (!file) {
+        throw std::runtime_error("Replay: unexpected end of file.");
+    }
+    return result;
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "RollingStats.hpp"
+
+RollingStats::RollingStats() :
+    nextIndex(0),
+    count(0)
+{
+
+}
+
+void RollingStats::add(double value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    samples[nextIndex] = value;
+    nextIndex = (nextIndex + 1) % CAPACITY;
+    count = std::min(count + 1, CAPACITY);
+}
+
+/**
+ * Gets the value of a given percentile in a sorted array.
+ *
+ * @param[in] sorted Sorted samples.
+ * @param[in] count Number of samples.
+ * @param[in] percent Percentile to get (in [0;100]).
+ * @return The value of the percentile (nearest-rank method).
+ */
+static double percentile(const std::array<double, RollingStats::CAPACITY>& sorted, std::size_t count, double percent) {
+    std::size_t rank = static_cast<std::size_t>(std::ceil(percent / 100 * count));
+    return sorted[std::max<std::size_t>(rank, 1) - 1];
+}
+
+RollingStats::Summary RollingStats::getSummary() const {
+    std::array<double, CAPACITY> sorted;
+    std::size_t nbSamples;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        nbSamples = count;
+        std::copy(samples.begin(), samples.begin() + count, sorted.begin());
+    }
+    Summary result = {nbSamples, 0, 0, 0, 0, 0};
+    if (nbSamples > 0) {
+        auto end = sorted.begin() + nbSamples;
+        std::sort(sorted.begin(), end);
+        result.min = sorted[0];
+        result.mean = std::accumulate(sorted.begin(), end, 0.0) / nbSamples;
+        result.p50 = percentile(sorted, nbSamples, 50);
+        result.p99 = percentile(sorted, nbSamples, 99);
+        result.max = sorted[nbSamples - 1];
+    }
+    return result;
+}
@@ -0,0 +1,277 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "BinaryStream.hpp"
+#include "lua/bindings/AIs.hpp"
+#include "lua/bindings/FundamentalTypes.hpp"
+#include "lua/bindings/insight.hpp"
+#include "lua/bindings/luaVirtualClass/pointers.hpp"
+#include "lua/bindings/luaVirtualClass/shared_ptr.hpp"
+#include "lua/bindings/robotics.hpp"
+#include "lua/bindings/std/shared_ptr.hpp"
+#include "lua/LuaException.hpp"
+#include "lua/types/LuaMethod.hpp"
+#include "lua/types/LuaNativeString.hpp"
+#include "Scene.hpp"
+
+Scene::Scene(double tickDuration, const World::Settings& worldSettings) :
+    world(worldSettings),
+    tickDuration(tickDuration),
+    recorder(nullptr)
+{
+
+}
+
+std::shared_ptr<Robot> Scene::newRobot(std::shared_ptr<RobotBody::ConstructionInfo> bodyInfo, const AIFactory& aiFactory) {
+    auto result = std::make_shared<Robot>(world, std::move(bodyInfo), aiFactory);
+    auto freeSlot = std::find(robots.begin(), robots.end(), nullptr);
+    std::size_t robotId = freeSlot - robots.begin();
+    if (recorder != nullptr) {
+        recorder->addRobot(robotId, result->body->getInterface());
+    }
+    if (freeSlot == robots.end()) {
+        robots.push_back(result);
+    } else {
+        *freeSlot = result;
+    }
+    return result;
+}
+
+void Scene::removeRobot(Robot& robot) {
+    auto it = std::find_if(robots.begin(), robots.end(), [&robot](const std::shared_ptr<Robot>& value) {
+        return value.get() == &robot;
+    });
+    if (it == robots.end()) {
+        throw std::invalid_argument("Scene: cannot remove a robot that is not in this scene.");
+    }
+    robot.body->removeFromWorld();
+    it->reset();
+}
+
+std::shared_ptr<Scene> Scene::fork() const {
+    auto result = std::make_shared<Scene>(tickDuration, world.getSettings());
+    result->world.setGravity(world.getGravity());
+    std::unordered_map<const Body*, std::size_t> robotIds;
+    for (std::size_t robotId = 0; robotId < robots.size(); robotId++) {
+        if (robots[robotId] == nullptr) {
+            continue;
+        }
+        for (auto& pair : robots[robotId]->body->getParts()) {
+            robotIds[pair.second.get()] = robotId;
+        }
+    }
+    // Preserves the insertion order of the bodies: robots are copied when their first part is found.
+    result->robots.resize(robots.size());
+    for (auto& object : world) {
+        auto it = robotIds.find(object.get());
+        if (it == robotIds.end()) {
+            result->world.addObject(object->clone());
+        } else if (result->robots[it->second] == nullptr) {
+            result->robots[it->second] = std::make_shared<Robot>(result->world, *robots[it->second]);
+        }
+    }
+    return result;
+}
+
+void Scene::saveSnapshot(std::ostream& stream) const {
+    world.saveSnapshot(stream);
+    writeBinary<std::uint32_t>(stream, robots.size());
+    std::vector<std::string> aiStates = saveAIStates();
+    for (std::size_t index = 0; index < robots.size(); index++) {
+        writeBinary<std::uint8_t>(stream, robots[index] != nullptr);
+        if (robots[index] != nullptr) {
+            writeBinaryString(stream, aiStates[index]);
+        }
+    }
+    if (!stream) {
+        throw std::runtime_error("Scene: failed to write the snapshot.");
+    }
+}
+
+void Scene::loadSnapshot(std::istream& stream) {
+    // The whole snapshot is read & checked before modifying the scene.
+    World::SnapshotData worldState = World::SnapshotData::read(stream);
+    if (readBinary<std::uint32_t>(stream) != robots.size()) {
+        throw std::runtime_error("Scene: the snapshot does not match the robots of this scene.");
+    }
+    std::vector<std::string> aiStates(robots.size());
+    for (std::size_t index = 0; index < robots.size(); index++) {
+        if (readBinary<std::uint8_t>(stream) != (robots[index] != nullptr)) {
+            throw std::runtime_error("Scene: the snapshot does not match the robots of this scene.");
+        }
+        if (robots[index] != nullptr) {
+            aiStates[index] = readBinaryString(stream);
+        }
+    }
+
+    World::SnapshotData previousWorldState = world.makeSnapshot();
+    std::vector<std::string> previousAIStates = saveAIStates();
+    world.applySnapshot(worldState);
+    try {
+        loadAIStates(aiStates);
+    } catch (...) {
+        // An AI rejected its state: the snapshot is applied entirely, or not at all.
+        world.applySnapshot(previousWorldState);
+        loadAIStates(previousAIStates);
+        throw;
+    }
+}
+
+std::vector<std::string> Scene::saveAIStates() const {
+    std::vector<std::string> result(robots.size());
+    for (std::size_t index = 0; index < robots.size(); index++) {
+        if (robots[index] != nullptr) {
+            std::ostringstream state;
+            robots[index]->ai->saveState(state);
+            result[index] = state.str();
+        }
+    }
+    return result;
+}
+
+void Scene::loadAIStates(const std::vector<std::string>& states) {
+    for (std::size_t index = 0; index < robots.size(); index++) {
+        if (robots[index] != nullptr) {
+            std::istringstream state(states[index]);
+            robots[index]->ai->loadState(state);
+            if (state.peek() != std::istringstream::traits_type::eof()) {
+                throw std::runtime_error("Scene: the snapshot does not match the AIs of this scene.");
+            }
+        }
+    }
+}
+
+void Scene::stepPhysics() {
+    world.stepSimulation(tickDuration);
+}
+
+void Scene::stepSimulation() {
+    // physics
+    if (recorder != nullptr) {
+        recorder->onStep();
+    }
+    world.stepSimulation(tickDuration);
+    // AI
+    for (auto& robot : robots) {
+        if (robot != nullptr && !robot->body->isSleeping()) {
+            robot->ai->stepSimulation();
+        }
+    }
+}
+
+void Scene::stepSimulation(FrameStats& stats) {
+    using clock = std::chrono::steady_clock;
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    auto start = clock::now();
+    if (recorder != nullptr) {
+        recorder->onStep();
+    }
+    world.stepSimulation(tickDuration);
+    auto physicsEnd = clock::now();
+    for (auto& robot : robots) {
+        if (robot != nullptr && !robot->body->isSleeping()) {
+            robot->ai->stepSimulation();
+        }
+    }
+    auto aiEnd = clock::now();
+
+    auto physicsTime = physicsEnd - start;
+    auto constraintsTime = world.getConstraintsTime();
+    auto publishTime = world.getPublishTime();
+    stats.physics.add(milliseconds(physicsTime).count());
+    stats.constraints.add(milliseconds(constraintsTime).count());
+    stats.publish.add(milliseconds(publishTime).count());
+    stats.bullet.add(milliseconds(physicsTime - constraintsTime - publishTime).count());
+    stats.ai.add(milliseconds(aiEnd - physicsEnd).count());
+    stats.lostSubStepTime = world.getLostTime().value;
+}
+
+void Scene::stepSimulation(unsigned nbTicks) {
+    for (unsigned tick = 0; tick < nbTicks; tick++) {
+        stepSimulation();
+    }
+}
+
+int Scene::luaIndex(const std::string& memberName, LuaStateView& state) {
+    using Method = LuaMethod<Scene>;
+    int result = 1;
+    if (memberName == "world") {
+        state.push<World*>(&world);
+    } else if (memberName == "newRobot") {
+        state.push<Method>([](Scene& object, LuaStateView& state) -> int {
+            auto bodyInfo = state.get<std::shared_ptr<RobotBody::ConstructionInfo>>(2);
+            AIFactory aiFactory = state.get<AIFactory>(3);
+            state.push<std::shared_ptr<Robot>>(object.newRobot(std::move(bodyInfo), aiFactory));
+            return 1;
+        });
+    } else if (memberName == "removeRobot") {
+        state.push<Method>([](Scene& object, LuaStateView& state) -> int {
+            auto robot = state.get<std::shared_ptr<Robot>>(2);
+            object.removeRobot(*robot);
+            return 0;
+        });
+    } else if (memberName == "step") {
+        state.push<Method>([](Scene& object, LuaStateView& state) -> int {
+            double nbTicks = state.get<double>(2);
+            if (!(nbTicks >= 0) || nbTicks > std::numeric_limits<unsigned>::max() || nbTicks != std::floor(nbTicks)) {
+                throw LuaException("Scene:step(): the number of ticks must be a positive integer.");
+            }
+            object.stepSimulation(static_cast<unsigned>(nbTicks));
+            return 0;
+        });
+    } else if (memberName == "fork") {
+        state.push<Method>([](Scene& object, LuaStateView& state) -> int {
+            state.push<std::shared_ptr<Scene>>(object.fork());
+            return 1;
+        });
+    } else if (memberName == "saveSnapshot") {
+        state.push<Method>([](Scene& object, LuaStateView& state) -> int {
+            std::string path = state.get<LuaNativeString>(2);
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Cannot create snapshot file: " + path);
+            }
+            object.saveSnapshot(file);
+            return 0;
+        });
+    } else if (memberName == "loadSnapshot") {
+        state.push<Method>([](Scene& object, LuaStateView& state) -> int {
+            std::string path = state.get<LuaNativeString>(2);
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Cannot open snapshot file: " + path);
+            }
+            object.loadSnapshot(file);
+            return 0;
+        });
+    } else {
+        result = 0;
+    }
+    return result;
+}
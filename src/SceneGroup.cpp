@@ -0,0 +1,123 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "SceneGroup.hpp"
+
+SceneGroup::SceneGroup() :
+    jobId(0),
+    jobTicks(0),
+    nextScene(0),
+    busyWorkers(0),
+    stopping(false)
+{
+
+}
+
+void SceneGroup::add(std::shared_ptr<Scene> scene) {
+    scenes.push_back(std::move(scene));
+}
+
+void SceneGroup::remove(const Scene& scene) {
+    auto it = std::find_if(scenes.begin(), scenes.end(), [&scene](const std::shared_ptr<Scene>& value) {
+        return value.get() == &scene;
+    });
+    if (it == scenes.end()) {
+        throw std::invalid_argument("SceneGroup: cannot remove a scene that is not in this group.");
+    }
+    scenes.erase(it);
+}
+
+void SceneGroup::step(unsigned nbTicks) {
+    if (scenes.empty()) {
+        return;
+    }
+    std::size_t nbThreads = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), scenes.size());
+    // The owner thread is also a worker.
+    while (workers.size() + 1 < nbThreads) {
+        workers.emplace_back(&SceneGroup::runWorker, this, jobId);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobTicks = nbTicks;
+        nextScene = 0;
+        busyWorkers = workers.size();
+        error = nullptr;
+        jobId++;
+    }
+    jobStarted.notify_all();
+    runJob();
+    std::exception_ptr jobError;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobFinished.wait(lock, [this]() { return busyWorkers == 0; });
+        jobError = std::move(error);
+        error = nullptr;
+    }
+    if (jobError) {
+        std::rethrow_exception(jobError);
+    }
+}
+
+void SceneGroup::runWorker(std::uint64_t lastJobId) {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobStarted.wait(lock, [this, lastJobId]() { return stopping || jobId != lastJobId; });
+            if (stopping) {
+                return;
+            }
+            lastJobId = jobId;
+        }
+        runJob();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        jobFinished.notify_one();
+    }
+}
+
+void SceneGroup::runJob() {
+    std::size_t index = nextScene++;
+    while (index < scenes.size()) {
+        try {
+            scenes[index]->stepSimulation(jobTicks);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        index = nextScene++;
+    }
+}
+
+SceneGroup::~SceneGroup() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobStarted.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
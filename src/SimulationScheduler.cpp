@@ -0,0 +1,63 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <stdexcept>
+
+#include "SimulationScheduler.hpp"
+
+SimulationScheduler::SimulationScheduler(duration tickDuration, duration maxLag) :
+    tickDuration(tickDuration),
+    maxLag(maxLag),
+    speed(1),
+    lastUpdate(clock::now()),
+    lag(0),
+    droppedTime(0)
+{
+
+}
+
+void SimulationScheduler::reset(clock::time_point now) {
+    lastUpdate = now;
+    lag = duration(0);
+}
+
+unsigned SimulationScheduler::update(clock::time_point now) {
+    lag+= std::chrono::duration_cast<duration>(now - lastUpdate) * speed;
+    lastUpdate = now;
+    duration maxSimulatedLag = maxLag * speed;
+    if (lag > maxSimulatedLag) {
+        droppedTime+= lag - maxSimulatedLag;
+        lag = maxSimulatedLag;
+    }
+    unsigned result = static_cast<unsigned>(std::floor(lag / tickDuration));
+    lag-= result * tickDuration;
+    return result;
+}
+
+SimulationScheduler::clock::time_point SimulationScheduler::getNextTickTime() const {
+    duration wallDelay = (tickDuration - lag) / speed;
+    return lastUpdate + std::chrono::duration_cast<clock::duration>(wallDelay);
+}
+
+void SimulationScheduler::setSpeed(double value) {
+    if (!(value > 0)) {
+        throw std::invalid_argument("Simulation speed must be strictly positive.");
+    }
+    speed = value;
+}
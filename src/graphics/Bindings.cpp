@@ -28,7 +28,9 @@
 #include "lua/types/LuaNativeString.hpp"
 #include "MouseMoveEvent.hpp"
 
-Bindings::Bindings() {
+Bindings::Bindings(std::mutex& mutex) :
+    mutex(mutex)
+{
     using KE = KeyInputEvent::KeyEvent;
     using MD = MouseMoveEvent::MouseDirection;
     actionToKey[Action::CameraForward] = std::make_unique<KeyInputEvent>(irr::KEY_KEY_W, KE::ButtonDown);
@@ -94,6 +96,7 @@ int Bindings::luaIndex(const std::string& memberName, LuaStateView& state) {
                 std::string errorMsg = std::string("Invalid event name: ") + eventName;
                 throw LuaException(errorMsg.c_str());
             }
+            std::lock_guard<std::mutex> lock(obj.mutex);
             obj.actionToKey[actionInfo.value] = std::move(event);
             return 0;
         });
@@ -101,6 +104,7 @@ int Bindings::luaIndex(const std::string& memberName, LuaStateView& state) {
     } else if (memberName == "get") {
         state.push<Method>([](Bindings& obj, LuaStateView& state) -> int {
             const ActionInfo& actionInfo = luaActionInfoByName(state, 2);
+            std::lock_guard<std::mutex> lock(obj.mutex);
             state.push<LuaNativeString>(obj.actionToKey[actionInfo.value]->getInputName().c_str());
             return 1;
         });
@@ -146,6 +146,7 @@ private:
 };
 
 Camera::Camera(irr::scene::ISceneManager& scene, const InputHandler& inputHandler) :
+    mutex(inputHandler.getMutex()),
     camera(scene.addCameraSceneNode(nullptr)),
     target(*scene.addEmptySceneNode(camera.get()))
 {
@@ -169,16 +170,20 @@ int Camera::luaIndex(const std::string& memberName, LuaStateView& state) {
     if (memberName == "setPosition") {
         state.push<Method>([](Camera& object, LuaStateView& state) -> int {
             auto pos = state.get<Vector3<SI::Length>>(2);
+            std::lock_guard<std::mutex> lock(object.mutex);
             object.setPosition(btToIrrVector(toIrrUnits(pos)));
             return 0;
         });
     } else if (memberName == "position") {
-        const irr::core::vector3df& rawPos = camera->getPosition();
+        std::unique_lock<std::mutex> lock(mutex);
+        irr::core::vector3df rawPos = camera->getPosition();
+        lock.unlock();
         auto pos = fromIrrValue<SI::Length>(irrToBtVector(rawPos));
         state.push<Vector3<SI::Length>>(pos);
     } else if (memberName == "lookAt") {
         state.push<Method>([](Camera& object, LuaStateView& state) -> int {
             auto pos = state.get<Vector3<SI::Length>>(2);
+            std::lock_guard<std::mutex> lock(object.mutex);
             object.camera->setTarget(btToIrrVector(toIrrUnits(pos)));
             return 0;
         });
@@ -25,9 +25,10 @@
 
 using namespace irr;
 
-void GraphicEngine::addBody(const Body& body) {
-    std::unique_ptr<GraphicObject> ptr = std::make_unique<GraphicObject>(body, sceneManager);
-    mapping[&body] = std::move(ptr);
+GraphicObject& GraphicEngine::addBody(const Body& body, const Shape& shape) {
+    std::unique_ptr<GraphicObject>& result = mapping[&body];
+    result = std::make_unique<GraphicObject>(shape, sceneManager);
+    return *result;
 }
 
 /**
@@ -47,7 +48,7 @@ GraphicEngine::GraphicEngine(const World& world) :
     sceneManager(*device->getSceneManager()),
     guienv(*device->getGUIEnvironment()),
     driver(*device->getVideoDriver()),
-    inputs(*device),
+    inputs(*device, mutex),
     camera(sceneManager, inputs),
     world(world)
 {
@@ -65,12 +66,33 @@ GraphicEngine::GraphicEngine(const World& world) :
     lightData.AmbientColor = video::SColorf(.2f, .2f, .2f);
 
     for (auto& body : world) {
-        addBody(*body.get());
+        addBody(*body, body->getShape()).updateTransform(body->getEngineTransform());
+    }
+    world.enableBodyEvents();
+}
+
+void GraphicEngine::updateScene() {
+    const TransformBuffer::Snapshot* snapshot = world.readTransforms();
+    if (snapshot != nullptr) {
+        for (const auto& event : snapshot->events) {
+            if (event.shape != nullptr) {
+                addBody(*event.body, *event.shape);
+            } else {
+                mapping.erase(event.body);
+            }
+        }
+        for (const auto& entry : snapshot->transforms) {
+            auto it = mapping.find(entry.body);
+            if (it != mapping.end()) {
+                it->second->updateTransform(entry.transform);
+            }
+        }
     }
-    world.addCreationListener(*this);
 }
 
 void GraphicEngine::run() {
+    std::lock_guard<std::mutex> lock(mutex);
+    updateScene();
     inputs.newFrame();
     if(device->run()) {
         inputs.doActions();
@@ -81,11 +103,6 @@ void GraphicEngine::run() {
     }
 }
 
-void GraphicEngine::onBodyCreation(const Body& newBody) {
-    addBody(newBody);
-}
-
-
 int GraphicEngine::luaIndex(const std::string& memberName, LuaStateView& state) {
     if (memberName=="camera") {
         state.push<Camera*>(&camera);
@@ -97,6 +114,4 @@ int GraphicEngine::luaIndex(const std::string& memberName, LuaStateView& state)
     return 0;
 }
 
-GraphicEngine::~GraphicEngine() {
-    world.removeCreationListener(*this);
-}
+GraphicEngine::~GraphicEngine() = default;
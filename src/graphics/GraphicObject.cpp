@@ -16,6 +16,9 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <memory>
+#include <unordered_map>
+
 #include "btConversions.hpp"
 #include "GraphicObject.hpp"
 #include "irrlicht_ptr.hpp"
@@ -55,8 +58,10 @@ public:
 
     void drawSphere(const btVector3& center, btScalar radius) override {
         irr::scene::ISceneManager& scene = *rootNode.getSceneManager();
+        static irrlicht_ptr<irr::scene::IMesh> sphere(makeSphereMesh(scene));
         irr::core::vector3df pos = btToIrrVector(center);
-        scene.addSphereSceneNode(radius, 16, &rootNode, -1, pos);
+        irr::core::vector3df scale(radius, radius, radius);
+        scene.addMeshSceneNode(sphere.get(), &rootNode, -1, pos, {0,0,0}, scale);
     }
 
     void drawCylinder(const btTransform& transform, const btVector3& halfExtents) override {
@@ -70,6 +75,14 @@ public:
         scene.addMeshSceneNode(cylinder.get(), &rootNode, -1, pos, rotation, scale);
     }
 
+    /* This implementation draws a cylinder and 2 spheres, reusing the shared meshes. */
+    void drawCapsule(const btTransform& transform, btScalar radius, btScalar halfHeight) override {
+        drawCylinder(transform, btVector3(radius, halfHeight, radius));
+        btVector3 axis = transform.getBasis().getColumn(1) * halfHeight;
+        drawSphere(transform.getOrigin() + axis, radius);
+        drawSphere(transform.getOrigin() - axis, radius);
+    }
+
     void drawCuboid(const btTransform& transform, const btVector3& halfExtents) override {
         irr::scene::ISceneManager& scene = *rootNode.getSceneManager();
         static irrlicht_ptr<irr::scene::IMesh> cuboid(makeCuboidMesh());
@@ -79,12 +92,12 @@ public:
         scene.addMeshSceneNode(cuboid.get(), &rootNode, -1, pos, rotation, scale);
     }
 
-    void drawMesh(const btTransform& transform, const ConvexMesh& physicsMesh) override {
+    void drawMesh(const btTransform& transform, const std::shared_ptr<const ConvexMesh>& physicsMesh) override {
         irr::scene::ISceneManager& scene = *rootNode.getSceneManager();
-        irrlicht_ptr<irr::scene::IMesh> mesh(makeMesh(physicsMesh));
+        irr::scene::IMesh& mesh = getCachedMesh(physicsMesh);
         irr::core::vector3df pos = btToIrrVector(transform.getOrigin());
         irr::core::vector3df rotation = btQuaternionToEulerAngles(transform.getRotation());
-        scene.addMeshSceneNode(mesh.get(), &rootNode, -1, pos, rotation);
+        scene.addMeshSceneNode(&mesh, &rootNode, -1, pos, rotation);
     }
 
     IrrlichtDrawer(irr::scene::ISceneNode& rootNode) : rootNode(rootNode) {
@@ -94,6 +107,57 @@ private:
     /** Node that will hold the 3d representation of a collision shape. */
     irr::scene::ISceneNode& rootNode;
 
+    /** Irrlicht mesh generated from a ConvexMesh of the physics engine. */
+    struct CachedMesh {
+        /** Mesh of the physics engine (used to detect address reuse). */
+        std::weak_ptr<const ConvexMesh> source;
+        /** Irrlicht mesh built from source. */
+        irrlicht_ptr<irr::scene::IMesh> mesh;
+    };
+
+    /**
+     * Gets the Irrlicht mesh of a ConvexMesh, building it only on the first request.
+     *
+     * Scene nodes hold their own reference on the mesh: entries of destroyed ConvexMesh are
+     * dropped from the cache without affecting existing nodes.
+     *
+     * @param physicsMesh Mesh of the physics engine.
+     * @return The Irrlicht mesh representing physicsMesh.
+     */
+    static irr::scene::IMesh& getCachedMesh(const std::shared_ptr<const ConvexMesh>& physicsMesh) {
+        static std::unordered_map<const ConvexMesh*, CachedMesh> cache;
+        auto it = cache.find(physicsMesh.get());
+        if (it != cache.end() && it->second.source.lock() == physicsMesh) {
+            return *it->second.mesh;
+        }
+        for (it = cache.begin(); it != cache.end(); /*empty*/) {
+            if (it->second.source.expired()) {
+                it = cache.erase(it);
+            } else {
+                it++;
+            }
+        }
+        CachedMesh& entry = cache[physicsMesh.get()];
+        entry.source = physicsMesh;
+        entry.mesh = makeMesh(*physicsMesh);
+        return *entry.mesh;
+    }
+
+    /**
+     * Generates a new sphere mesh.
+     *
+     * Centered on {0,0,0}, radius 1.
+     *
+     * @param[in] scene Scene manager used to create the mesh.
+     * @param[in] tesselation Number of segments along each angle of the sphere.
+     * @return A mesh representing a sphere.
+     */
+    static irrlicht_ptr<irr::scene::IMesh> makeSphereMesh(irr::scene::ISceneManager& scene, irr::u32 tesselation = 16) {
+        irrlicht_ptr<irr::scene::IMesh> result(scene.getGeometryCreator()->createSphereMesh(1, tesselation, tesselation));
+        result->getMeshBuffer(0)->getMaterial().NormalizeNormals = true;
+        return result;
+    }
+
     /**
      * Generates a new cylinder mesh.
      *
@@ -253,8 +317,9 @@ private:
     /**
      * Generates an Irrlicht mesh from the mesh representation of the physics engine.
      *
-     * @param vertices List of vertices of the mesh.
-     * @param faces List of faces of the mesh.
+     * Vertices are duplicated per triangle, in order to have flat shading.
+     *
+     * @param physicsMesh Mesh from the physics engine.
      * @return An irrlicht shape built from the arguments.
      */
     static irrlicht_ptr<irr::scene::IMesh> makeMesh(const ConvexMesh& physicsMesh) {
@@ -263,12 +328,17 @@ private:
         irrlicht_ptr<SMeshBuffer> meshBuffer(new SMeshBuffer());
         result->addMeshBuffer(meshBuffer.get());
 
+        const std::vector<btVector3>& vertices = physicsMesh.getVertices();
+        const std::vector<unsigned>& indices = physicsMesh.getIndices();
+        const std::vector<btVector3>& normals = physicsMesh.getNormals();
+        meshBuffer->Vertices.reallocate(indices.size());
+        meshBuffer->Indices.reallocate(indices.size());
         unsigned index = 0;
-        for (const auto& triangle : physicsMesh.getTriangles()) {
-            irr::core::vector3df normal = btToIrrVector(triangle->getNormal());
+        for (unsigned triangle = 0; triangle < physicsMesh.getTriangleCount(); triangle++) {
+            irr::core::vector3df normal = btToIrrVector(normals[triangle]);
             irr::video::S3DVertex vertex({0,0,0}, normal, irr::video::SColor(255,255,255,255), {0,0});
-            for (const btVector3& physicsVertex : triangle->getVertices()) {
-                vertex.Pos = btToIrrVector(physicsVertex);
+            for (unsigned k = 0; k < 3; k++) {
+                vertex.Pos = btToIrrVector(vertices[indices[3*triangle+k]]);
                 meshBuffer->Vertices.push_back(vertex);
                 meshBuffer->Indices.push_back(index);
                 index++;
@@ -278,23 +348,14 @@ private:
     }
 };
 
-GraphicObject::GraphicObject(const Body& body, irr::scene::ISceneManager& scene) :
-    body(body),
+GraphicObject::GraphicObject(const Shape& shape, irr::scene::ISceneManager& scene) :
     node(scene.addEmptySceneNode(nullptr))
 {
     IrrlichtDrawer drawer(*node);
-    body.drawShape(drawer);
-    updateTransform(body.getEngineTransform());
-    body.addMoveListener(*this);
+    shape.draw(drawer);
 }
 
-void GraphicObject::onBodyMove(const btTransform& transform) {
-    updateTransform(transform);
-}
-
-GraphicObject::~GraphicObject() {
-    body.removeMoveListener(*this);
-}
+GraphicObject::~GraphicObject() = default;
 
 void GraphicObject::updateTransform(const btTransform& transform) {
     node->setPosition(btToIrrVector(transform.getOrigin()));
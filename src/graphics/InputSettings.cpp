@@ -100,10 +100,12 @@ public:
     /**
      * Constructs a new setting element.
      * @param wrappedValue Reference to the value storing the setting data.
+     * @param mutex Mutex to lock while accessing the value.
      */
     template<typename Unit>
-    Setting(Units::Float<Unit>& wrappedValue) :
-        impl(std::make_unique<UnitEraserImpl<Unit>>(wrappedValue))
+    Setting(Units::Float<Unit>& wrappedValue, std::mutex& mutex) :
+        impl(std::make_unique<UnitEraserImpl<Unit>>(wrappedValue)),
+        mutex(&mutex)
     {
 
     }
@@ -115,9 +117,19 @@ public:
     UnitEraser& getImpl() {
         return *impl;
     }
+
+    /**
+     * Gets the mutex to lock while accessing the value.
+     * @return The mutex protecting the setting value.
+     */
+    std::mutex& getMutex() {
+        return *mutex;
+    }
 private:
     /** Virtual object abstracting the unit of the underlying Float<...>. */
     std::unique_ptr<UnitEraser> impl;
+    /** Mutex to lock while accessing the value. */
+    std::mutex* mutex;
 };
 
 template<typename Unit>
@@ -149,11 +161,13 @@ public:
         using Method = LuaMethod<Setting>;
         int result = 1;
         if (memberName == "value") {
+            std::lock_guard<std::mutex> lock(object.getMutex());
             object.getImpl().luaPush(state);
         } else if (memberName == "unit") {
             state.push<LuaNativeString>(object.getImpl().getUnitSymbol().c_str());
         } else if (memberName == "setValue") {
             state.push<Method>([](Setting& object, LuaStateView& state) -> int {
+                std::lock_guard<std::mutex> lock(object.getMutex());
                 object.getImpl().luaGet(state,2);
                 return 0;
             });
@@ -164,11 +178,14 @@ public:
     }
 
     static std::string luaToStringImpl(Setting& object) {
+        std::lock_guard<std::mutex> lock(object.getMutex());
         return object.getImpl().luaToString();
     }
 };
 
-InputSettings::InputSettings() {
+InputSettings::InputSettings(std::mutex& mutex) :
+    mutex(mutex)
+{
     cameraTranslationSpeed = Units::Float<SI::Speed>(5);
     cameraRotationSpeed = Units::Float<SI::AngularVelocity>(0.45);
 }
@@ -181,7 +198,7 @@ InputSettings::InputSettings() {
  */
 template<auto InputSettings::*member>
 Setting settingCreator(InputSettings& settings) {
-    return Setting(settings.*member);
+    return Setting(settings.*member, settings.getMutex());
 }
 
 /**
@@ -20,6 +20,7 @@
 #define BINDINGS_HPP
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "irrlicht.h"
@@ -40,13 +41,19 @@ public:
         return *actionToKey.at(action);
     }
 
-    /** Constructs a new bindings with a default mapping for QWERTY keyboards. */
-    Bindings();
+    /**
+     * Constructs a new bindings with a default mapping for QWERTY keyboards.
+     *
+     * @param mutex Mutex held while rendering (locked by the Lua methods of this object).
+     */
+    Bindings(std::mutex& mutex);
 
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
 
 private:
     std::unordered_map<Action, std::unique_ptr<InputEvent>> actionToKey;
+    /** Mutex held while rendering. */
+    std::mutex& mutex;
 };
 
 #endif /* BINDINGS_HPP */
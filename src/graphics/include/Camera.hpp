@@ -20,6 +20,7 @@
 #define CAMERA_HPP
 
 #include <memory>
+#include <mutex>
 
 #include "irrlicht.h"
 
@@ -56,6 +57,8 @@ private:
         }
     };
 
+    /** Mutex held while rendering (locked by the Lua methods of this camera). */
+    std::mutex& mutex;
     /** Scene node of the camera in Irrlicht. */
     std::unique_ptr<irr::scene::ICameraSceneNode, CameraDeleter> camera;
     irr::scene::ISceneNode& target;
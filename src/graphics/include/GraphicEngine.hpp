@@ -19,9 +19,9 @@
 #define	GRAPHICENGINE_HPP
 
 #include <irrlicht.h>
+#include <mutex>
 #include <unordered_map>
 
-#include "BodyCreationListener.hpp"
 #include "Camera.hpp"
 #include "GraphicObject.hpp"
 #include "InputHandler.hpp"
@@ -29,7 +29,7 @@
 #include "World.hpp"
 #include "irrlicht_ptr.hpp"
 
-class GraphicEngine : public LuaVirtualClass, public BodyCreationListener {
+class GraphicEngine : public LuaVirtualClass {
 private:
     /** Irrlicht device. */
     irrlicht_ptr<irr::IrrlichtDevice> device;
@@ -40,6 +40,14 @@ private:
     /** Irrlicht driver. */
     irr::video::IVideoDriver& driver;
 
+    /**
+     * Mutex protecting the scene graph & the inputs.
+     *
+     * Held by run() while rendering a frame, and by the Lua methods of the camera &
+     * the inputs (called by the thread running the shell commands).
+     */
+    std::mutex mutex;
+
     /** Object managing mouse & keyboard inputs. */
     InputHandler inputs;
 
@@ -54,9 +62,19 @@ private:
     /**
      * Adds a new GraphicObject representing an object in the physics engine.
      *
-     * @param[in] body Object in the physics engine to represent.
+     * @param[in] body Object in the physics engine to represent (only used as a key).
+     * @param[in] shape Shape of the body.
+     * @return The new GraphicObject (placed at the origin).
      */
-    void addBody(const Body& body);
+    GraphicObject& addBody(const Body& body, const Shape& shape);
+
+    /**
+     * Updates the GraphicObjects according to the latest snapshot published by the world.
+     *
+     * Bodies added & removed in the world are added & removed from the scene, then
+     * the moved bodies are updated.
+     */
+    void updateScene();
 public:
     /**
      * Creates a new graphic engine.
@@ -69,7 +87,9 @@ public:
      * Run the engine.
      *
      * This function will handle events (mouse clicks, window resize, ...), and
-     * render the next frame.
+     * render the next frame with the latest snapshot published by the world. It
+     * never waits for the thread stepping the world (except while a shell command
+     * uses the camera or the inputs).
      *
      * @return True if the window was not closed.
      */
@@ -77,8 +97,6 @@ public:
 
     virtual ~GraphicEngine();
 
-    void onBodyCreation(const Body& newBody) override;
-
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
 };
 
@@ -23,27 +23,32 @@
 
 #include "irrlicht.h"
 
-#include "Body.hpp"
+#include "Shape.hpp"
 
 /**
  * Representation of an object from the physics engine.
  */
-class GraphicObject : public BodyMoveListener {
+class GraphicObject {
 public:
     /**
      * Creates a 3d node representing an object from the physics engine.
      *
-     * @param body Object of the simulation to render.
+     * The object is placed at the origin, until the first call to updateTransform().
+     *
+     * @param shape Shape of the object of the simulation to render.
      * @param scene Scene in which this object should be rendered.
      */
-    GraphicObject(const Body& body, irr::scene::ISceneManager& scene);
+    GraphicObject(const Shape& shape, irr::scene::ISceneManager& scene);
 
-    void onBodyMove(const btTransform& transform) override;
+    /**
+     * Updates the position & location of this object.
+     *
+     * @param[in] transform New position & orientation of the object.
+     */
+    void updateTransform(const btTransform& transform);
 
     virtual ~GraphicObject();
 private:
-    /** Object in the physics engine represented by this GraphicObject. */
-    const Body& body;
 
     /**
      * Custom deleter for a scene node (for std::unique_ptr).
@@ -57,13 +62,6 @@ private:
 
     /** Irrlicht node containing the 3d objects of this GraphicObject.*/
     std::unique_ptr<irr::scene::ISceneNode, NodeDeleter> node;
-
-    /**
-     * Updates the position & location of this object.
-     *
-     * @param[in] transform New position & orientation of the object.
-     */
-    void updateTransform(const btTransform& transform);
 };
 
 #endif /* GRAPHICOBJECT_HPP */
@@ -19,6 +19,8 @@
 #ifndef INPUTHANDLER_HPP
 #define INPUTHANDLER_HPP
 
+#include <mutex>
+
 #include "irrlicht.h"
 
 #include "Action.hpp"
@@ -75,10 +77,14 @@ public:
      * Creates a new input handler.
      *
      * @param device Irrlicht device.
+     * @param mutex Mutex held while rendering (locked by the Lua methods of the inputs).
      */
-    InputHandler(irr::IrrlichtDevice& device) :
+    InputHandler(irr::IrrlichtDevice& device, std::mutex& mutex) :
         device(device),
-        mouse(*device.getCursorControl(), *device.getVideoDriver())
+        mutex(mutex),
+        bindings(mutex),
+        mouse(*device.getCursorControl(), *device.getVideoDriver()),
+        settings(mutex)
     {
 
     }
@@ -92,10 +98,21 @@ public:
         return settings;
     }
 
+    /**
+     * Gets the mutex held while rendering.
+     *
+     * @return The mutex to lock before modifying the scene from another thread.
+     */
+    std::mutex& getMutex() const {
+        return mutex;
+    }
+
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
 private:
     /** Irrlicht device. */
     irr::IrrlichtDevice& device;
+    /** Mutex held while rendering. */
+    std::mutex& mutex;
     /** Object mapping keyboard & mouse button to GUI actions. */
     Bindings bindings;
     /** Keyboard handler. */
@@ -20,6 +20,7 @@
 #define INPUTSETTINGS_HPP
 
 #include <map>
+#include <mutex>
 #include <unordered_map>
 
 #include "lua/types/LuaVirtualClass.hpp"
@@ -29,15 +30,30 @@
 /** Class holdings all settings related to user inputs in the GUI. */
 class InputSettings : public LuaVirtualClass {
 public:
-    /** Creates a new InputSettings with default values. */
-    InputSettings();
+    /**
+     * Creates a new InputSettings with default values.
+     *
+     * @param mutex Mutex held while rendering (locked by the Lua methods of the settings).
+     */
+    InputSettings(std::mutex& mutex);
 
     /** Camera rotation speed around each axis. */
     Units::Float<SI::AngularVelocity> cameraRotationSpeed;
     /** Camera translation speed on each axis. */
     Units::Float<SI::Speed> cameraTranslationSpeed;
 
+    /**
+     * Gets the mutex held while rendering.
+     * @return The mutex to lock while accessing the settings from another thread.
+     */
+    std::mutex& getMutex() const {
+        return mutex;
+    }
+
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
+private:
+    /** Mutex held while rendering. */
+    std::mutex& mutex;
 };
 
 #endif /* INPUTSETTINGS_HPP */
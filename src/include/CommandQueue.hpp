@@ -0,0 +1,105 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMMANDQUEUE_HPP
+#define COMMANDQUEUE_HPP
+
+#include <atomic>
+#include <functional>
+
+/**
+ * Lock-free multiple producers, single consumer queue of commands.
+ *
+ * Any thread can push commands. A single thread (the consumer) runs them, at a
+ * time of its choosing. Producers never wait for each other, nor for the consumer.
+ *
+ * Implementation of the intrusive MPSC queue from Dmitry Vyukov.
+ */
+class CommandQueue {
+public:
+    /** Type of the commands stored in this queue. */
+    using Command = std::function<void()>;
+
+    /** Creates an empty queue. */
+    CommandQueue();
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    /**
+     * Adds a new command at the end of the queue.
+     *
+     * Can be called by any thread.
+     *
+     * @param[in] command Command to add.
+     */
+    void push(Command command);
+
+    /**
+     * Checks if there is a command ready to run.
+     *
+     * Must be called only by the consumer thread.
+     *
+     * @return True if no command is ready.
+     */
+    bool empty() const;
+
+    /**
+     * Runs the command at the front of this queue (and removes it).
+     *
+     * Must be called only by the consumer thread.
+     *
+     * @return True if a command was run, false if the queue was empty.
+     */
+    bool runNext();
+
+    /**
+     * Runs all the commands of this queue.
+     *
+     * Must be called only by the consumer thread.
+     */
+    void runAll();
+
+    ~CommandQueue();
+private:
+    /** Node of the linked list storing the commands. */
+    struct Node {
+        /**
+         * Creates a new node.
+         * @param[in] command Command stored in this node.
+         */
+        Node(Command command) :
+            next(nullptr),
+            command(std::move(command))
+        {
+
+        }
+
+        /** Next node in the list. */
+        std::atomic<Node*> next;
+        /** Command stored in this node. */
+        Command command;
+    };
+
+    /** Last pushed node (shared by producers). */
+    std::atomic<Node*> head;
+    /** Node before the first command (owned by the consumer). */
+    Node* tail;
+};
+
+#endif /* COMMANDQUEUE_HPP */
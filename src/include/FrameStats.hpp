@@ -0,0 +1,57 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAMESTATS_HPP
+#define FRAMESTATS_HPP
+
+#include "lua/types/LuaVirtualClass.hpp"
+#include "RollingStats.hpp"
+
+/**
+ * Timing statistics of the different phases of the main loops (in milliseconds).
+ *
+ * Each phase is readable from Lua as a table {count, min, mean, p50, p99, max}.
+ */
+class FrameStats : public LuaVirtualClass {
+public:
+    /** Total time spent in World::stepSimulation(). */
+    RollingStats physics;
+    /** Time spent in the internal ticks of Bullet (physics, excluding constraints). */
+    RollingStats bullet;
+    /** Time spent in Constraint::beforeTick() (joint friction & motors). */
+    RollingStats constraints;
+    /** Time spent publishing the moved, added & removed bodies to the render thread. */
+    RollingStats publish;
+    /** Time spent stepping the AIs. */
+    RollingStats ai;
+    /** Time spent rendering a frame. */
+    RollingStats render;
+    /** Time spent sleeping by the physics thread. */
+    RollingStats sleep;
+    /** Simulated time dropped because the simulation could not keep up with wall time (in seconds). */
+    double droppedTime;
+    /** Simulated time lost by the physics engine because of the maximum number of substeps (in seconds). */
+    double lostSubStepTime;
+
+    /** Creates empty statistics. */
+    FrameStats();
+
+    int luaIndex(const std::string& memberName, LuaStateView& state) override;
+};
+
+#endif /* FRAMESTATS_HPP */
@@ -0,0 +1,136 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECORDER_HPP
+#define RECORDER_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#include "ActionObserver.hpp"
+#include "AIInterface.hpp"
+
+/**
+ * Records the inputs of a simulation into a binary file.
+ *
+ * The file contains a sequence of events, in the order they happened: Lua commands,
+ * simulation steps, and values set into the action signals of the robots. Replaying
+ * these events in a freshly built scene (see Replay) reproduces the same simulation.
+ *
+ * Format: a header (MAGIC, VERSION, sizeof(btScalar)), then events. Each event is
+ * an Event byte followed by its payload:
+ * - Event::command: std::uint32_t length, Lua code.
+ * - Event::step: no payload.
+ * - Event::defineAction: std::uint32_t action id, std::uint32_t robot id, std::uint32_t length, action name.
+ * - Event::actionFloat: std::uint32_t action id, float value.
+ * - Event::actionVector: std::uint32_t action id, 3 btScalar values.
+ *
+ * Numbers are written in the native byte order: a record must be replayed on the
+ * same kind of machine.
+ *
+ * The file is flushed after each command, and every FLUSH_PERIOD steps, so that a
+ * crash loses at most a few steps.
+ *
+ * Inputs of the GUI (key bindings, mouse) are not recorded: they only move the
+ * camera. Lua code reading them (insight.gui.inputs) won't be reproduced by a replay.
+ */
+class Recorder : public ActionObserver {
+public:
+    /** Type of the events of a record. */
+    enum class Event : std::uint8_t {
+        command,      /**< Lua command from the shell. */
+        step,         /**< Step of the physics engine. */
+        defineAction, /**< Attributes an id to an action signal of a robot. */
+        actionFloat,  /**< New value of a float action signal. */
+        actionVector, /**< New value of a btVector3 action signal. */
+    };
+
+    /** Magic bytes at the beginning of a record file. */
+    static constexpr char MAGIC[4] = {'I','N','S','R'};
+    /** Version of the file format. */
+    static constexpr std::uint8_t VERSION = 1;
+    /** Number of steps between two flushes of the file. */
+    static constexpr std::uint32_t FLUSH_PERIOD = 60;
+
+    /**
+     * Creates a new record file.
+     *
+     * @param[in] path Path of the file to create.
+     */
+    Recorder(const std::string& path);
+
+    /**
+     * Starts recording the actions of a robot.
+     *
+     * @param[in] robotId Identifier of the robot in its scene.
+     * @param interface Interface of the robot.
+     */
+    void addRobot(std::uint32_t robotId, AIInterface& interface);
+
+    /**
+     * Records a Lua command.
+     *
+     * @param[in] command Lua code executed.
+     */
+    void onCommand(const std::string& command);
+
+    /**
+     * Records a step of the physics engine.
+     */
+    void onStep();
+
+    void onAction(const ActionSignal& action, float value) override;
+
+    void onAction(const ActionSignal& action, const btVector3& value) override;
+private:
+    /** Output file. */
+    std::ofstream file;
+    /** Map giving the id of each recorded action signal. */
+    std::unordered_map<const ActionSignal*, std::uint32_t> actionIds;
+    /** Number of steps recorded since the last flush. */
+    std::uint32_t unflushedSteps;
+
+    /**
+     * Writes a value in its binary representation.
+     *
+     * @param[in] value Value to write.
+     * @tparam T Type of the value.
+     */
+    template<typename T>
+    void write(const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /**
+     * Writes a string (length, then characters).
+     *
+     * @param[in] value String to write.
+     */
+    void writeString(const std::string& value);
+
+    /**
+     * Gets the id of an action signal.
+     * @param[in] action Action signal.
+     * @return The id of the action signal.
+     */
+    std::uint32_t getActionId(const ActionSignal& action) const;
+};
+
+#endif /* RECORDER_HPP */
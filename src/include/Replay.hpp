@@ -0,0 +1,121 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "Action.hpp"
+#include "ActionSignal.hpp"
+#include "Scene.hpp"
+#include "ShellInterpreter.hpp"
+
+/**
+ * Replays a file written by a Recorder.
+ *
+ * The events are applied to a freshly built scene: Lua commands are executed in the
+ * given shell, steps only run the physics engine, and the actions of the robots are
+ * set from the recorded values (instead of running the AIs).
+ */
+class Replay {
+public:
+    /**
+     * Opens a record file.
+     *
+     * @param[in] path Path of the record file.
+     * @param scene Scene in which the events are applied.
+     * @param shell Shell executing the recorded commands.
+     */
+    Replay(const std::string& path, Scene& scene, ShellInterpreter& shell);
+
+    /**
+     * Reads & applies the next event of the record.
+     *
+     * @return False if the end of the record was reached.
+     */
+    bool next();
+
+    /**
+     * Gets the number of steps replayed.
+     * @return The number of steps replayed.
+     */
+    std::uint64_t getStepCount() const {
+        return stepCount;
+    }
+private:
+    /** Input file. */
+    std::ifstream file;
+    /** Scene in which the events are applied. */
+    Scene& scene;
+    /** Shell executing the recorded commands. */
+    ShellInterpreter& shell;
+    /** Recorded action signals, by id. */
+    std::unordered_map<std::uint32_t, ActionSignal*> actions;
+    /** Number of steps replayed. */
+    std::uint64_t stepCount;
+
+    /**
+     * Reads a value in its binary representation.
+     *
+     * @return The value read.
+     * @tparam T Type of the value.
+     */
+    template<typename T>
+    T read() {
+        T result;
+        file.read(reinterpret_cast<char*>(&result), sizeof(T));
+        if (!file) {
+            throw std::runtime_error("Replay: unexpected end of file.");
+        }
+        return result;
+    }
+
+    /**
+     * Reads a string (length, then characters).
+     *
+     * @return The string read.
+     */
+    std::string readString();
+
+    /**
+     * Gets a recorded action signal of a specific type.
+     *
+     * @param[in] actionId Identifier of the action.
+     * @return The action signal.
+     * @tparam T Type of the action signal.
+     */
+    template<typename T>
+    Action<T>& getAction(std::uint32_t actionId) {
+        auto it = actions.find(actionId);
+        Action<T>* result = nullptr;
+        if (it != actions.end()) {
+            result = dynamic_cast<Action<T>*>(it->second);
+        }
+        if (result == nullptr) {
+            throw std::runtime_error("Replay: invalid action id.");
+        }
+        return *result;
+    }
+};
+
+#endif /* REPLAY_HPP */
@@ -20,6 +20,7 @@
 #define ROBOT_HPP
 
 #include <memory>
+#include <sstream>
 
 #include "AI.hpp"
 #include "AIFactory.hpp"
@@ -29,15 +30,37 @@
 struct Robot {
     Robot(World& world, std::shared_ptr<RobotBody::ConstructionInfo> bodyInfo, const AIFactory& aiFactory) :
         body(std::make_unique<RobotBody>(world, bodyInfo)),
-        ai(aiFactory.createAI(body->getInterface()))
+        ai(aiFactory.createAI(body->getInterface())),
+        aiFactory(aiFactory)
     {
 
     }
 
+    /**
+     * Creates a copy of a robot in another world.
+     *
+     * The body is copied with its current dynamic state. A new AI is created by
+     * the factory of the source, and receives the state of the AI of the source.
+     *
+     * @param world World in which the copy will be created.
+     * @param source Robot to copy.
+     */
+    Robot(World& world, const Robot& source) :
+        body(std::make_unique<RobotBody>(world, *source.body)),
+        ai(source.aiFactory.createAI(body->getInterface())),
+        aiFactory(source.aiFactory)
+    {
+        std::stringstream aiState;
+        source.ai->saveState(aiState);
+        ai->loadState(aiState);
+    }
+
     /** Body of this robot. */
     std::unique_ptr<RobotBody> body;
     /** AI of this robot. */
     std::unique_ptr<AI> ai;
+    /** Factory used to create the AI of this robot. */
+    AIFactory aiFactory;
 };
 
 #endif /* ROBOT_HPP */
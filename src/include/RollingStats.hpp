@@ -0,0 +1,80 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROLLINGSTATS_HPP
+#define ROLLINGSTATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * Statistics over the latest samples of a measure.
+ *
+ * Samples are stored in a fixed-size ring buffer: only the latest CAPACITY samples are used.
+ * Samples can be added and read from different threads.
+ */
+class RollingStats {
+public:
+    /** Maximum number of samples used to compute the statistics. */
+    static constexpr std::size_t CAPACITY = 256;
+
+    /** Statistics of the stored samples. */
+    struct Summary {
+        /** Number of samples. */
+        std::size_t count;
+        /** Minimum value. */
+        double min;
+        /** Average value. */
+        double mean;
+        /** Median value. */
+        double p50;
+        /** 99th percentile. */
+        double p99;
+        /** Maximum value. */
+        double max;
+    };
+
+    /** Creates an object without samples. */
+    RollingStats();
+
+    /**
+     * Adds a new sample (replacing the oldest one if the buffer is full).
+     *
+     * @param[in] value New sample.
+     */
+    void add(double value);
+
+    /**
+     * Computes the statistics of the stored samples.
+     *
+     * @return The statistics of the stored samples (all 0 if there's no sample).
+     */
+    Summary getSummary() const;
+private:
+    /** Mutex protecting this object. */
+    mutable std::mutex mutex;
+    /** Ring buffer of samples. */
+    std::array<double, CAPACITY> samples;
+    /** Index in samples where the next value will be written. */
+    std::size_t nextIndex;
+    /** Number of valid values in samples. */
+    std::size_t count;
+};
+
+#endif /* ROLLINGSTATS_HPP */
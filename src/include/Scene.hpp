@@ -0,0 +1,201 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCENE_HPP
+#define SCENE_HPP
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "AIFactory.hpp"
+#include "FrameStats.hpp"
+#include "lua/types/LuaVirtualClass.hpp"
+#include "Recorder.hpp"
+#include "Robot.hpp"
+#include "RobotBody.hpp"
+#include "World.hpp"
+
+/**
+ * Independent simulation: a World, with its robots & their AIs.
+ *
+ * Scenes don't share any mutable state, so different scenes can be stepped
+ * concurrently by different threads. Shapes (immutable) can be shared between
+ * scenes: robots created from the same RobotBody::ConstructionInfo use the same
+ * Shape objects.
+ */
+class Scene : public LuaVirtualClass {
+public:
+    /**
+     * Creates a new empty scene.
+     *
+     * @param[in] tickDuration Simulated time of a single step (in seconds).
+     * @param[in] worldSettings Construction parameters of the world of this scene.
+     */
+    Scene(double tickDuration, const World::Settings& worldSettings = World::Settings());
+
+    /**
+     * Gets the physics engine of this scene.
+     * @return The world of this scene.
+     */
+    World& getWorld() {
+        return world;
+    }
+
+    /**
+     * Gets the physics engine of this scene.
+     * @return The world of this scene.
+     */
+    const World& getWorld() const {
+        return world;
+    }
+
+    /**
+     * Creates a new robot in this scene.
+     *
+     * @param[in] bodyInfo Description of the body of the robot.
+     * @param[in] aiFactory Factory creating the AI of the robot.
+     * @return The new robot.
+     */
+    std::shared_ptr<Robot> newRobot(std::shared_ptr<RobotBody::ConstructionInfo> bodyInfo, const AIFactory& aiFactory);
+
+    /**
+     * Removes a robot from this scene.
+     *
+     * Its body parts & joints are removed from the world. Its identifier is
+     * reused by the next call to newRobot().
+     *
+     * @param robot Robot to remove.
+     */
+    void removeRobot(Robot& robot);
+
+    /**
+     * Gets a robot from its identifier.
+     *
+     * Robots are numbered from 0, in creation order. Identifiers of removed robots
+     * are reused by the next robots.
+     *
+     * @param[in] robotId Identifier of the robot.
+     * @return The robot with the given identifier.
+     */
+    Robot& getRobot(std::size_t robotId) {
+        Robot* result = robots.at(robotId).get();
+        if (result == nullptr) {
+            throw std::out_of_range("Scene: no robot with this identifier.");
+        }
+        return *result;
+    }
+
+    /**
+     * Sets the recorder of this scene.
+     *
+     * The recorder will be informed of the steps of this scene, and of the actions
+     * of the robots created after this call.
+     *
+     * @param value The new recorder (can be null).
+     */
+    void setRecorder(Recorder* value) {
+        recorder = value;
+    }
+
+    /**
+     * Creates an independent copy of this scene.
+     *
+     * Bodies, joints & robots are recreated in the same order, with the same dynamic
+     * state. Shapes & joint infos are shared with this scene. The recorder is not
+     * copied.
+     *
+     * @return The new scene.
+     */
+    std::shared_ptr<Scene> fork() const;
+
+    /**
+     * Saves the state of this scene (world snapshot, followed by the states of the AIs).
+     *
+     * @param stream Binary output stream.
+     */
+    void saveSnapshot(std::ostream& stream) const;
+
+    /**
+     * Restores a snapshot written by saveSnapshot().
+     *
+     * The scene must contain the same bodies, constraints & robots as the scene
+     * that wrote the snapshot. The whole snapshot is read & checked before modifying
+     * the scene: if it is invalid, the scene is left unchanged.
+     *
+     * @param stream Binary input stream.
+     */
+    void loadSnapshot(std::istream& stream);
+
+    /**
+     * Runs a single step of the physics engine (without running the AIs).
+     *
+     * Used to replay a simulation, where the actions of the AIs are read from a record.
+     */
+    void stepPhysics();
+
+    /**
+     * Runs a single step of the simulation (physics & AIs).
+     */
+    void stepSimulation();
+
+    /**
+     * Runs a single step of the simulation, and records the time spent in each phase.
+     *
+     * @param stats Object in which the timings are recorded.
+     */
+    void stepSimulation(FrameStats& stats);
+
+    /**
+     * Runs several steps of the simulation.
+     *
+     * @param[in] nbTicks Number of steps to run.
+     */
+    void stepSimulation(unsigned nbTicks);
+
+    int luaIndex(const std::string& memberName, LuaStateView& state) override;
+private:
+    /** Physics engine. */
+    World world;
+    /** List of robots (index: robot identifier, null for removed robots). */
+    std::vector<std::shared_ptr<Robot>> robots;
+    /** Simulated time of a single step (in seconds). */
+    double tickDuration;
+    /** Recorder of this scene (can be null). */
+    Recorder* recorder;
+
+    /**
+     * Gets the states of the AIs (see AI::saveState()).
+     *
+     * @return The state of the AI of each robot (index: robot identifier, empty for removed robots).
+     */
+    std::vector<std::string> saveAIStates() const;
+
+    /**
+     * Sets the states of the AIs (no rollback).
+     *
+     * @param states State of the AI of each robot (see saveAIStates()).
+     */
+    void loadAIStates(const std::vector<std::string>& states);
+};
+
+#endif /* SCENE_HPP */
@@ -0,0 +1,127 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCENEGROUP_HPP
+#define SCENEGROUP_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Scene.hpp"
+
+/**
+ * Set of scenes stepped together, in parallel.
+ *
+ * The scenes are distributed on a pool of threads owned by this group. The
+ * threads are created by the first calls to step(), and are reused by all the
+ * following calls.
+ *
+ * Methods of this class must be called by a single thread (the owner).
+ */
+class SceneGroup {
+public:
+    /** Creates an empty group (without any thread). */
+    SceneGroup();
+
+    SceneGroup(const SceneGroup&) = delete;
+    SceneGroup& operator=(const SceneGroup&) = delete;
+
+    /**
+     * Adds a scene to this group.
+     *
+     * @param[in] scene Scene to add.
+     */
+    void add(std::shared_ptr<Scene> scene);
+
+    /**
+     * Removes a scene from this group.
+     *
+     * The group releases its reference to the scene: it is destroyed when no
+     * other owner is left.
+     *
+     * @param[in] scene Scene to remove.
+     */
+    void remove(const Scene& scene);
+
+    /**
+     * Gets the number of scenes in this group.
+     * @return The number of scenes in this group.
+     */
+    std::size_t size() const {
+        return scenes.size();
+    }
+
+    /**
+     * Runs several steps of the simulation of all the scenes of this group, in parallel.
+     *
+     * This function returns when all the scenes have been stepped. The calling
+     * thread also steps scenes. Scenes with a multithreaded world
+     * (World::Settings::threads > 1) share Bullet's task scheduler: they are
+     * stepped one after the other, in parallel with the single-threaded ones.
+     *
+     * If some scenes throw an exception, the other scenes are still stepped,
+     * then the first exception is rethrown.
+     *
+     * @param[in] nbTicks Number of steps to run in each scene.
+     */
+    void step(unsigned nbTicks);
+
+    ~SceneGroup();
+private:
+    /** Scenes of this group. */
+    std::vector<std::shared_ptr<Scene>> scenes;
+    /** Pool of threads stepping the scenes (the owner thread is not in this list). */
+    std::vector<std::thread> workers;
+    /** Mutex protecting the job & the state of the pool. */
+    std::mutex mutex;
+    /** Signaled when a new job is started, or when the pool is stopped. */
+    std::condition_variable jobStarted;
+    /** Signaled when a worker has finished its part of the current job. */
+    std::condition_variable jobFinished;
+    /** Identifier of the current job (incremented by each call to step()). */
+    std::uint64_t jobId;
+    /** Number of steps to run in each scene, in the current job. */
+    unsigned jobTicks;
+    /** Index of the next scene to step, in the current job. */
+    std::atomic<std::size_t> nextScene;
+    /** Number of workers still running the current job. */
+    std::size_t busyWorkers;
+    /** First exception thrown by a scene in the current job. */
+    std::exception_ptr error;
+    /** True if the workers must exit. */
+    bool stopping;
+
+    /**
+     * Main loop of a worker thread.
+     *
+     * @param[in] lastJobId Identifier of the last job started before the creation of the worker.
+     */
+    void runWorker(std::uint64_t lastJobId);
+
+    /** Steps scenes of the current job, until all of them have been taken by a thread. */
+    void runJob();
+};
+
+#endif /* SCENEGROUP_HPP */
@@ -0,0 +1,107 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIMULATIONSCHEDULER_HPP
+#define SIMULATIONSCHEDULER_HPP
+
+#include <chrono>
+
+/**
+ * Computes how many fixed ticks of simulation must be run to follow wall time.
+ *
+ * The simulated time follows the wall time multiplied by a real-time factor (the speed).
+ * If the simulation falls behind, several ticks are run to catch up. If it falls too
+ * far behind (the machine is too slow), the excess time is dropped and reported.
+ */
+class SimulationScheduler {
+public:
+    /** Clock used to measure wall time. */
+    using clock = std::chrono::steady_clock;
+    /** Duration type used by this scheduler (seconds). */
+    using duration = std::chrono::duration<double>;
+
+    /**
+     * Creates a new scheduler.
+     *
+     * @param[in] tickDuration Simulated time of a single tick.
+     * @param[in] maxLag Maximum lag (in wall time) before dropping simulated time.
+     */
+    SimulationScheduler(duration tickDuration, duration maxLag);
+
+    /**
+     * Restarts the scheduling from the given time, forgetting any lag.
+     *
+     * Must be called when the simulation is resumed.
+     *
+     * @param[in] now Current time.
+     */
+    void reset(clock::time_point now);
+
+    /**
+     * Computes the number of ticks to run to catch up with the wall time.
+     *
+     * The caller must run exactly this number of ticks.
+     *
+     * @param[in] now Current time.
+     * @return The number of ticks to run.
+     */
+    unsigned update(clock::time_point now);
+
+    /**
+     * Gets the time at which the next tick should be run.
+     * @return The wall time of the next tick.
+     */
+    clock::time_point getNextTickTime() const;
+
+    /**
+     * Gets the real-time factor.
+     * @return The ratio simulated time / wall time.
+     */
+    double getSpeed() const {
+        return speed;
+    }
+
+    /**
+     * Sets the real-time factor.
+     * @param[in] value New ratio simulated time / wall time (strictly positive).
+     */
+    void setSpeed(double value);
+
+    /**
+     * Gets the simulated time that was dropped because the simulation could not keep up.
+     * @return The total dropped simulated time.
+     */
+    duration getDroppedTime() const {
+        return droppedTime;
+    }
+private:
+    /** Simulated time of a single tick. */
+    duration tickDuration;
+    /** Maximum lag (in wall time) before dropping simulated time. */
+    duration maxLag;
+    /** Ratio simulated time / wall time. */
+    double speed;
+    /** Wall time of the last update. */
+    clock::time_point lastUpdate;
+    /** Simulated time that should have been simulated, but wasn't yet. */
+    duration lag;
+    /** Total of simulated time dropped. */
+    duration droppedTime;
+};
+
+#endif /* SIMULATIONSCHEDULER_HPP */
@@ -15,30 +15,47 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cmath>
 #include <condition_variable>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include <boost/dll.hpp>
 #include <boost/program_options.hpp>
 
 #include "AI.hpp"
 #include "AIFactory.hpp"
+#include "CommandQueue.hpp"
+#include "FrameStats.hpp"
 #include "GraphicEngine.hpp"
 #include "lua/bindings/AIs.hpp"
 #include "lua/bindings/insight.hpp"
 #include "lua/bindings/luaVirtualClass/pointers.hpp"
+#include "lua/bindings/luaVirtualClass/shared_ptr.hpp"
+#include "lua/bindings/physics.hpp"
 #include "lua/bindings/robotics.hpp"
 #include "lua/bindings/std/shared_ptr.hpp"
+#include "lua/LuaException.hpp"
 #include "lua/types/LuaFunction.hpp"
 #include "lua/types/LuaMethod.hpp"
 #include "lua/types/LuaVirtualClass.hpp"
 #include "Robot.hpp"
 #include "RobotBody.hpp"
+#include "Recorder.hpp"
+#include "Replay.hpp"
+#include "Scene.hpp"
+#include "SceneGroup.hpp"
+#include "SimulationScheduler.hpp"
 #include "ShellInterpreter.hpp"
 #include "ShellInterpreterConfig.hpp"
 #include "version.hpp"
@@ -47,8 +64,8 @@
 /**
  * Represents possible states of the Insight class.
  *
- * Enables the control thread (Lua shell) to control worker threads (computing the
- * simulation).
+ * Enables the control thread (Lua shell) to stop worker threads (computing &
+ * rendering the simulation).
  */
 class InsightState {
 private:
@@ -56,8 +73,6 @@ private:
     enum class State {
         stopped,  /**< Nothing is running. */
         running,  /**< Simulation is running. */
-        pausing,  /**< Worker threads requested to sleep. */
-        paused,   /**< Simulation on pause. */
         stopping  /**< Worker threads requested to terminate. */
     };
 
@@ -65,10 +80,6 @@ private:
     std::atomic<State> state;
     /** Mutex protecting state for RMW operations (read operations can be done directly to state). */
     std::mutex mutex;
-    /** Condition variable used to pause worker threads. */
-    std::condition_variable workerCondition;
-    /** Condition variable used by control thread to wait for worker threads. */
-    std::condition_variable controlCondition;
 public:
     /**
      * Creates a new InsightState in stopped mode.
@@ -91,20 +102,18 @@ public:
     /**
      * Send a command to terminate worker threads.
      *
-     * Possible only from State::paused and State::running.
+     * Possible only from State::running.
      */
     void stopping() {
-        std::unique_lock<std::mutex> lock(mutex);
+        std::lock_guard<std::mutex> lock(mutex);
         switch(state) {
         case State::stopped:
             break;
-        case State::paused:
         case State::running:
             state = State::stopping;
-            workerCondition.notify_all();
             break;
         default:
-            throw std::logic_error("Cannot request stop: object is not 'paused' or 'running'.");
+            throw std::logic_error("Cannot request stop: object is not 'running'.");
         }
     }
 
@@ -122,81 +131,22 @@ public:
     }
 
     /**
-     * Sends a command to the worker thread to resume the simulation.
-     *
-     * Possible only from State::paused.
-     */
-    void resume() {
-        std::unique_lock<std::mutex> lock(mutex);
-        switch(state) {
-        case State::running:
-            break;
-        case State::paused:
-            state = State::running;
-            lock.unlock();
-            workerCondition.notify_all();
-            break;
-        default:
-            throw std::logic_error("Cannot run: object not in 'paused' or 'running' mode.");
-        }
-    }
-
-    /**
-     * Sends a command to the worker thread to pause the simulation.
-     *
-     * Possible only from State::running or State:: pausing.
-     *
-     * @param[in] sleepUntilPaused True to wait until the worker thread stopped. False to just send a pause signal.
-     * @return True if this call did pause the threads (they were running before this call).
-     */
-    bool pause(bool sleepUntilPaused) {
-        std::unique_lock<std::mutex> lock(mutex);
-        bool result = false;
-        switch (state) {
-        case State::paused:
-            break;
-        case State::running:
-            state = State::pausing;
-            result = true;
-            // no break
-        case State::pausing:
-            if (sleepUntilPaused) {
-                controlCondition.wait(lock, [this]() -> bool { return this->state != State::pausing; });
-            }
-            break;
-        default:
-            throw std::logic_error("Cannot pause: object is not in 'paused', 'pausing' or 'running' state.");
-        }
-        return result;
-    }
-
-    /**
-     * Tests if this object is in paused state.
-     * @return True if paused, false otherwise.
+     * Tests if this object is in stopped state.
+     * @return True if stopped, false otherwise.
      */
-    bool isPaused() {
-        return (state==State::paused);
+    bool isStopped() {
+        return (state==State::stopped);
     }
 
     /**
-     * Wait to be in a non-paused state, then tests for running state.
+     * Tests if this object is in running state.
      *
-     * If the state is pausing, the calling thread will sleep until the state
-     * changes. Then, it will return true if the application is in a 'running' state,
-     * and false in other cases.
+     * Worker threads exit their main loop once this returns false.
      *
      * @return True if the state is 'running'.
      */
-    bool waitRunningState() {
-        State readState = state;
-        if (readState == State::pausing) {
-            std::unique_lock<std::mutex> lock(mutex);
-            state = State::paused;
-            controlCondition.notify_all();
-            workerCondition.wait(lock, [this]() -> bool { return this->state != State::paused;} );
-            readState = state;
-        }
-        return (readState == State::running);
+    bool isRunning() {
+        return (state==State::running);
     }
 };
 
@@ -281,9 +231,24 @@ private:
     std::mutex mutex;
 };
 
+/**
+ * Makes a Lua string literal.
+ *
+ * @param[in] value Content of the string.
+ * @return A Lua long bracket string containing value.
+ */
+static std::string toLuaString(const std::string& value) {
+    std::string level;
+    while (value.find("]" + level + "]") != std::string::npos) {
+        level+= "=";
+    }
+    return "[" + level + "[" + value + "]" + level + "]";
+}
+
 class Insight : public LuaVirtualClass {
 private:
     using timer = std::chrono::steady_clock;
+    using milliseconds = std::chrono::duration<double, std::milli>;
 
     /** Shell interpreter callbacks for Insight. */
     class ShellConfig : public ShellInterpreterConfig {
@@ -295,7 +260,6 @@ private:
          */
         ShellConfig(Insight& insight, const std::vector<std::string>& initScripts) :
             insight(insight),
-            mustResume(false),
             initScripts(initScripts)
         {
 
@@ -315,42 +279,90 @@ private:
             state.push<Insight*>(&insight);
             state.setGlobal("insight");
             for (const auto& script : initScripts) {
-                state.doFile(script);
+                execute(state, "dofile(" + toLuaString(script) + ")");
             }
         }
 
-
-        void beforeCommand(LuaStateView& state) override {
-            mustResume = insight.pauseWorker(true);
-        }
-
-        void afterCommand(LuaStateView& state) override {
-            if (mustResume && insight.insightState.isPaused()) {
-                insight.resumeWorker();
+        /**
+         * Runs a shell command in the physics thread.
+         *
+         * A command ending with '&' is fire-and-forget: the shell doesn't wait for it,
+         * and its errors are printed by the physics thread. Other commands (queries,
+         * snapshots...) are waited for.
+         *
+         * @param state The Lua state of the shell.
+         * @param command Lua code to execute.
+         */
+        void execute(LuaStateView& state, const std::string& command) override {
+            std::string code = command;
+            bool async = removeAsyncMarker(code);
+            auto run = [this, &state, code]() {
+                if (insight.recorder != nullptr) {
+                    insight.recorder->onCommand(code);
+                }
+                state.doString(code);
+            };
+            if (async) {
+                insight.postCommand([run]() {
+                    try {
+                        run();
+                    } catch (const LuaException& e) {
+                        std::cerr << e.what() << std::endl;
+                    }
+                });
+            } else {
+                insight.runCommand(run);
             }
         }
     private:
         /** Insight instance owning this config.*/
         Insight& insight;
-        /** Resume the worker thread in afterCommand, if it was paused by beforeCommand.*/
-        bool mustResume;
         /** List of scripts to execute when the shell is starting. */
         const std::vector<std::string>& initScripts;
+
+        /**
+         * Removes the trailing '&' of a fire-and-forget command.
+         *
+         * @param[in,out] command Shell command (the '&' is removed from it).
+         * @return True if the command ended with '&'.
+         */
+        static bool removeAsyncMarker(std::string& command) {
+            auto last = command.find_last_not_of(" \t\r");
+            if (last != std::string::npos && command[last] == '&') {
+                command.erase(last);
+                return true;
+            }
+            return false;
+        }
     };
 
-    /** World & physics engine. */
-    World world;
-    /** List of robots. */
-    std::unordered_set<std::shared_ptr<Robot>> robots;
-    /** Graphics engine. */
-    GraphicEngine graphicEngine;
+    /** Simulated time of a physics tick. */
+    std::chrono::duration<std::int64_t, std::nano> physicsPeriod;
+    /** Main scene (world, robots & AIs), simulated in real time and rendered. */
+    Scene scene;
+    /** Recorder of the main scene (can be null). */
+    std::unique_ptr<Recorder> recorder;
+    /** Additional scenes, only stepped on request (see stepWorlds()). */
+    SceneGroup worlds;
+    /** Graphics engine (null in headless mode). */
+    std::unique_ptr<GraphicEngine> graphicEngine;
     /** Shell configuration. */
     ShellConfig shellConfig;
     /** Lua shell (stdin/stdout) interpreter. */
     ShellInterpreter interpreter;
     /** Time between two renders (inverse of the framerate). */
     std::chrono::duration<std::int64_t, std::nano> renderPeriod;
-    /** Holds the state of this object, and handles worker thread control (stop & pause). */
+    /** Timings of the main loops. */
+    FrameStats stats;
+    /** Scheduler of the ticks of the main scene. */
+    SimulationScheduler scheduler;
+    /** Commands sent to the physics thread (run between two ticks). */
+    CommandQueue commands;
+    /** Flag set once the physics thread stopped running the commands (see postCommand()). */
+    std::atomic<bool> commandsClosed;
+    /** Mutex held by the threads running the commands after commandsClosed is set. */
+    std::mutex closedCommandsMutex;
+    /** Holds the state of this object, and handles worker thread control (stop). */
     InsightState insightState;
     /** Holds the state of the simulation, and handles worker thread control (can skip simulation and run the GUI only). */
     SimulationState simulationState;
@@ -358,26 +370,108 @@ private:
     std::string frameworkDir;
 
     /**
-     * Worker thread main loop : computes the simulation.
+     * Physics thread main loop : computes the simulation (physics & AIs).
      *
-     * Other threads (Lua interpreter thread) can pause or stop this loop using
-     * insightState.
+     * The world is stepped by fixed ticks (physicsPeriod), independently of the
+     * render thread. The scheduler decides how many ticks must be run to follow the
+     * wall time (times the speed factor). Other threads (Lua interpreter thread) can
+     * stop this loop using insightState, pause the simulation using simulationState,
+     * or send commands to run between two ticks.
+     *
+     * In headless mode, there is no scheduling: a tick is run on each iteration, as
+     * fast as possible.
      */
-    void workerMainLoop() {
-        while (insightState.waitRunningState()) {
-            auto start = timer::now();
-            if (simulationState.isRunning()) {
-                // physics
-                world.stepSimulation(std::chrono::duration<double>(renderPeriod).count());
-                // AI
-                for (auto& robot : robots) {
-                    robot->ai->stepSimulation();
+    void physicsMainLoop() {
+        bool wasRunning = false;
+        bool wasLagging = false;
+        bool clampWarned = false;
+        while (insightState.isRunning()) {
+            bool running = simulationState.isRunning();
+            if (running) {
+                double lostSubStepTime = stats.lostSubStepTime;
+                if (graphicEngine == nullptr) {
+                    scene.stepSimulation(stats);
+                } else {
+                    if (!wasRunning) {
+                        scheduler.reset(timer::now());
+                    }
+                    unsigned nbTicks = scheduler.update(timer::now());
+                    for (unsigned tick = 0; tick < nbTicks; tick++) {
+                        scene.stepSimulation(stats);
+                    }
+                    double droppedTime = scheduler.getDroppedTime().count();
+                    bool isLagging = (droppedTime != stats.droppedTime);
+                    if (isLagging && !wasLagging) {
+                        std::cerr << "Warning: the simulation can't keep up with the requested speed (x" << scheduler.getSpeed() << "). Dropping simulated time." << std::endl;
+                    }
+                    wasLagging = isLagging;
+                    stats.droppedTime = droppedTime;
+                }
+                bool isClamped = (lostSubStepTime != stats.lostSubStepTime);
+                if (isClamped && !clampWarned) {
+                    const World::Settings& settings = scene.getWorld().getSettings();
+                    std::cerr << "Warning: a tick needs more than " << settings.maxSubSteps << " substeps of ";
+                    std::cerr << settings.fixedTimeStep.value << " s. Simulated time is lost (see insight.stats.lostSubStepTime)." << std::endl;
+                    clampWarned = true;
+                }
+            }
+            wasRunning = running;
+            runCommands();
+            auto now = timer::now();
+            if (graphicEngine != nullptr || !running) {
+                auto nextTick = now + physicsPeriod;
+                if (running) {
+                    nextTick = scheduler.getNextTickTime();
                 }
+                std::this_thread::sleep_until(nextTick);
+                stats.sleep.add(milliseconds(timer::now() - now).count());
             }
-            // gui
-            graphicEngine.run();
+        }
+        // Commands pushed from now on are run by their producer (see postCommand()).
+        commandsClosed.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        runClosedCommands();
+    }
+
+    /**
+     * Runs the pending commands from other threads.
+     *
+     * Called by the physics thread between two ticks. The commands don't lock the
+     * render thread: bodies added, removed or moved by the commands are published to
+     * it in a snapshot, like the bodies moved by a tick.
+     */
+    void runCommands() {
+        if (!commands.empty()) {
+            commands.runAll();
+            scene.getWorld().publishTransforms();
+        }
+    }
+
+    /**
+     * Runs the pending commands once the physics thread has exited its loop.
+     *
+     * Called by the physics thread when it exits, then by any thread pushing a command
+     * after that: no command is left in the queue, and no shell waits forever.
+     */
+    void runClosedCommands() {
+        std::lock_guard<std::mutex> lock(closedCommandsMutex);
+        commands.runAll();
+    }
+
+    /**
+     * Render thread main loop : displays the latest published state of the world.
+     *
+     * This loop doesn't wait for the physics thread: it renders the latest snapshot
+     * of the bodies (see World::publishTransforms()). Only the shell commands using
+     * the camera or the inputs wait for the frame being rendered.
+     */
+    void renderMainLoop() {
+        while (insightState.isRunning()) {
+            auto start = timer::now();
+            graphicEngine->run();
 
             auto ellapsed = timer::now() - start;
+            stats.render.add(milliseconds(ellapsed).count());
 
             if (ellapsed < renderPeriod) {
                 auto sleepTime = renderPeriod - ellapsed;
@@ -386,6 +480,8 @@ private:
         }
     }
 public:
+    /** Number of ticks per simulated second of the main scene. */
+    static constexpr unsigned TICK_RATE = 60;
 
     /**
      * Constructs a new Insight object.
@@ -394,15 +490,24 @@ public:
      *
      * @param[in] luaInitScripts List of Lua scripts to execute when starting the shell.
      * @param[in] frameworkDir Path to the framework.
+     * @param[in] headless True to run without any graphic engine (no window, no framerate limit).
+     * @param[in] recordPath File in which the simulation is recorded (empty string to disable recording).
+     * @param[in] worldSettings Construction parameters of the world of the main scene.
      */
-    Insight(const std::vector<std::string>& luaInitScripts, const std::string& frameworkDir) :
-        graphicEngine(world),
+    Insight(const std::vector<std::string>& luaInitScripts, const std::string& frameworkDir, bool headless,
+            const std::string& recordPath, const World::Settings& worldSettings) :
+        physicsPeriod(std::chrono::nanoseconds(1000000000/TICK_RATE)),
+        scene(std::chrono::duration<double>(physicsPeriod).count(), worldSettings),
+        recorder(recordPath.empty() ? nullptr : std::make_unique<Recorder>(recordPath)),
+        graphicEngine(headless ? nullptr : std::make_unique<GraphicEngine>(scene.getWorld())),
         shellConfig(*this, luaInitScripts),
         interpreter(shellConfig),
         renderPeriod(std::chrono::nanoseconds(1000000000/60)),
+        scheduler(physicsPeriod, std::chrono::milliseconds(100)),
+        commandsClosed(false),
         frameworkDir(frameworkDir)
     {
-
+        scene.setRecorder(recorder.get());
     }
 
     /**
@@ -441,39 +546,164 @@ public:
         simulationState.pause(false);
 
         std::thread shellThread([this]() { this->interpreter.run(); });
-        workerMainLoop();
+        if (graphicEngine != nullptr) {
+            // The Irrlicht device must be used from the thread that created it.
+            std::thread physicsThread([this]() { this->physicsMainLoop(); });
+            renderMainLoop();
+            physicsThread.join();
+        } else {
+            physicsMainLoop();
+        }
 
         shellThread.join();
         insightState.stop();
     }
 
     /**
-     * Pauses the worker thread.
+     * Sends a command to the physics thread, without waiting for it (fire-and-forget).
      *
-     * This function sends a pause request to the worker thread, and waits
-     * until the worker acknowledges the request.
+     * The command is run between two ticks, after the commands pushed before it. It
+     * must handle its own exceptions.
      *
-     * @param[in] sleepUntilPaused True to wait until the worker thread stopped. False to just send a pause signal.
-     * @return True if this call actually paused the thread (it was not paused before).
+     * @param[in] command Command to run.
      */
-    bool pauseWorker(bool sleepUntilPaused) {
-        return insightState.pause(sleepUntilPaused);
+    void postCommand(CommandQueue::Command command) {
+        if (insightState.isStopped()) {
+            // No physics thread (replay).
+            command();
+            return;
+        }
+        commands.push(std::move(command));
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (commandsClosed.load()) {
+            // The physics thread might have drained the queue before this push.
+            runClosedCommands();
+        }
+    }
+
+    /**
+     * Runs a command in the physics thread, between two ticks.
+     *
+     * This function waits until the command is executed, and rethrows its exceptions.
+     * The simulation keeps running while the caller waits.
+     *
+     * @param[in] command Command to run.
+     */
+    void runCommand(const std::function<void()>& command) {
+        auto done = std::make_shared<std::promise<void>>();
+        std::future<void> result = done->get_future();
+        postCommand([&command, done]() {
+            try {
+                command();
+                done->set_value();
+            } catch (...) {
+                done->set_exception(std::current_exception());
+            }
+        });
+        result.get();
+    }
+
+    /**
+     * Creates a new scene, independent from the main one.
+     *
+     * @param[in] worldSettings Construction parameters of the world of the new scene.
+     * @return The new scene.
+     */
+    std::shared_ptr<Scene> newWorld(const World::Settings& worldSettings) {
+        auto result = std::make_shared<Scene>(std::chrono::duration<double>(physicsPeriod).count(), worldSettings);
+        worlds.add(result);
+        return result;
+    }
+
+    /**
+     * Creates a copy of the main scene, stepped with the scenes of newWorld().
+     *
+     * @return The new scene.
+     */
+    std::shared_ptr<Scene> forkWorld() {
+        auto result = scene.fork();
+        worlds.add(result);
+        return result;
+    }
+
+    /**
+     * Removes a scene created by newWorld() or forkWorld().
+     *
+     * The scene is no longer stepped by stepWorlds(), and is destroyed once
+     * the Lua scripts drop their references to it.
+     *
+     * @param[in] world Scene to remove.
+     */
+    void removeWorld(const Scene& world) {
+        worlds.remove(world);
+    }
+
+    /**
+     * Steps all the scenes created by newWorld() & forkWorld() in parallel.
+     *
+     * @param[in] nbTicks Number of steps to run in each scene.
+     */
+    void stepWorlds(unsigned nbTicks) {
+        worlds.step(nbTicks);
+    }
+
+    /**
+     * Replays a simulation recorded with the --record option.
+     *
+     * The events of the record are applied as fast as possible in the calling thread,
+     * without rendering. The recorded commands are executed in the Lua shell.
+     *
+     * @param[in] path Path of the record file.
+     */
+    void replay(const std::string& path) {
+        Replay replay(path, scene, interpreter);
+        interpreter.init();
+        auto start = timer::now();
+        while (replay.next()) {
+
+        }
+        std::chrono::duration<double> ellapsed = timer::now() - start;
+        std::cout << "Replay finished: " << replay.getStepCount() << " steps in " << ellapsed.count() << " s." << std::endl;
     }
 
     /**
-     * Resumes the worker thread.
+     * Runs a script, then a fixed number of ticks of the main scene (batch mode).
+     *
+     * Everything runs in the calling thread, before run(): there is no rendering, no
+     * scheduling and no worker thread. The script is
+     * executed in the Lua shell (after the init scripts).
      *
-     * This function just sends a resume request to the worker thread.
+     * @param[in] script Path of the Lua script to execute (empty string for none).
+     * @param[in] nbSteps Number of ticks to run after the script.
+     * @return False if the script failed, true otherwise.
      */
-    void resumeWorker() {
-        insightState.resume();
+    bool runBatch(const std::string& script, unsigned nbSteps) {
+        interpreter.init();
+        if (!script.empty() && !interpreter.execute("dofile(" + toLuaString(script) + ")")) {
+            return false;
+        }
+        auto start = timer::now();
+        for (unsigned step = 0; step < nbSteps; step++) {
+            scene.stepSimulation(stats);
+        }
+        if (nbSteps > 0) {
+            std::chrono::duration<double> ellapsed = timer::now() - start;
+            std::cout << "Batch finished: " << nbSteps << " steps in " << ellapsed.count() << " s (";
+            std::cout << nbSteps / ellapsed.count() << " steps/s)." << std::endl;
+            if (stats.lostSubStepTime > 0) {
+                std::cout << "Warning: " << stats.lostSubStepTime << " s of simulated time lost by the maxSubSteps limit." << std::endl;
+            }
+        }
+        return true;
     }
 
     int luaIndex(const std::string& memberName, LuaStateView& state) override {
         using Method = LuaMethod<Insight>;
         int result = 1;
         if (memberName == "world") {
-            state.push<World*>(&world);
+            state.push<World*>(&scene.getWorld());
+        } else if (memberName == "scene") {
+            state.push<Scene*>(&scene);
         } else if (memberName == "newRobotInfo") {
             state.push<LuaFunction>([](LuaStateView& state) -> int {
                 using ConstructionInfo = RobotBody::ConstructionInfo;
@@ -485,13 +715,50 @@ public:
             state.push<Method>([](Insight& object, LuaStateView& state) -> int {
                 auto bodyInfo = state.get<std::shared_ptr<RobotBody::ConstructionInfo>>(2);
                 AIFactory aiFactory = state.get<AIFactory>(3);
-                auto newRobot = std::make_shared<Robot>(object.world, bodyInfo, aiFactory);
-                state.push<std::shared_ptr<Robot>>(newRobot);
-                object.robots.insert(newRobot);
+                state.push<std::shared_ptr<Robot>>(object.scene.newRobot(std::move(bodyInfo), aiFactory));
                 return 1;
             });
+        } else if (memberName == "removeRobot") {
+            state.push<Method>([](Insight& object, LuaStateView& state) -> int {
+                auto robot = state.get<std::shared_ptr<Robot>>(2);
+                object.scene.removeRobot(*robot);
+                return 0;
+            });
+        } else if (memberName == "newWorld") {
+            state.push<Method>([](Insight& object, LuaStateView& state) -> int {
+                World::Settings settings;
+                if (state.getTop() >= 2 && !state.isNil(2)) {
+                    settings = state.get<World::Settings>(2);
+                }
+                state.push<std::shared_ptr<Scene>>(object.newWorld(settings));
+                return 1;
+            });
+        } else if (memberName == "forkWorld") {
+            state.push<Method>([](Insight& object, LuaStateView& state) -> int {
+                state.push<std::shared_ptr<Scene>>(object.forkWorld());
+                return 1;
+            });
+        } else if (memberName == "removeWorld") {
+            state.push<Method>([](Insight& object, LuaStateView& state) -> int {
+                auto world = state.get<std::shared_ptr<Scene>>(2);
+                object.removeWorld(*world);
+                return 0;
+            });
+        } else if (memberName == "stepWorlds") {
+            state.push<Method>([](Insight& object, LuaStateView& state) -> int {
+                double nbTicks = state.get<double>(2);
+                if (!(nbTicks >= 0) || nbTicks > std::numeric_limits<unsigned>::max() || nbTicks != std::floor(nbTicks)) {
+                    throw LuaException("insight:stepWorlds(): the number of ticks must be a positive integer.");
+                }
+                object.stepWorlds(static_cast<unsigned>(nbTicks));
+                return 0;
+            });
         } else if (memberName == "graphicEngine") {
-            state.push<GraphicEngine*>(&graphicEngine);
+            if (graphicEngine != nullptr) {
+                state.push<GraphicEngine*>(graphicEngine.get());
+            } else {
+                result = 0;
+            }
         } else if (memberName == "quit") {
             state.push<Method>([](Insight& object, LuaStateView& state) -> int {
                 object.quit();
@@ -507,6 +774,19 @@ public:
                 object.resume();
                 return 0;
             });
+        } else if (memberName == "stats") {
+            state.push<FrameStats*>(&stats);
+        } else if (memberName == "speed") {
+            state.push<double>(scheduler.getSpeed());
+        } else if (memberName == "setSpeed") {
+            state.push<Method>([](Insight& object, LuaStateView& state) -> int {
+                double speed = state.get<double>(2);
+                if (!(speed > 0)) {
+                    throw LuaException("insight:setSpeed(): the speed must be strictly positive.");
+                }
+                object.scheduler.setSpeed(speed);
+                return 0;
+            });
         } else if (memberName == "dir") {
             state.push<LuaNativeString>(frameworkDir.c_str());
         } else {
@@ -535,6 +815,26 @@ public:
         static constexpr char insightDir[] = "insightDir";
         /** Disable automatic execution of init.lua in insightDir. */
         static constexpr char noDefaultInit[] = "noDefaultInit";
+        /** Runs the simulation without graphic engine. */
+        static constexpr char headless[] = "headless";
+        /** Records the simulation into a file. */
+        static constexpr char record[] = "record";
+        /** Replays a recorded simulation. */
+        static constexpr char replay[] = "replay";
+        /** Executes a Lua script before starting the shell (batch mode). */
+        static constexpr char script[] = "script";
+        /** Number of ticks to run after the script (batch mode). */
+        static constexpr char steps[] = "steps";
+        /** Exits after the batch, without starting the shell. */
+        static constexpr char exit[] = "exit";
+        /** Number of threads stepping the world of the main scene. */
+        static constexpr char physicsThreads[] = "physicsThreads";
+        /** Number of substeps per second of the physics engine of the main scene. */
+        static constexpr char substepRate[] = "substepRate";
+        /** Maximum number of substeps per tick of the main scene. */
+        static constexpr char maxSubSteps[] = "maxSubSteps";
+        /** Number of iterations of the constraint solver of the main scene. */
+        static constexpr char solverIterations[] = "solverIterations";
     };
 
     /**
@@ -555,10 +855,52 @@ public:
         variable_map variables = parse(argc, argv);
         help = (variables.count(Switch::help) > 0);
         version = (variables.count(Switch::version) > 0);
+        headless = (variables.count(Switch::headless) > 0);
+        record = variables[Switch::record].as<std::string>();
+        replay = variables[Switch::replay].as<std::string>();
+        script = variables[Switch::script].as<std::string>();
+        steps = variables[Switch::steps].as<unsigned>();
+        exitAfterBatch = (variables.count(Switch::exit) > 0);
+        worldSettings.threads = variables[Switch::physicsThreads].as<unsigned>();
+        if (worldSettings.threads == 0) {
+            throw std::invalid_argument("Option --physicsThreads must be at least 1.");
+        }
+        double substepRate = variables[Switch::substepRate].as<double>();
+        if (!(substepRate > 0)) {
+            throw std::invalid_argument("Option --substepRate must be positive.");
+        }
+        worldSettings.fixedTimeStep = Scalar<SI::Time>(1 / substepRate);
+        // Substeps needed to cover a whole tick (the epsilon absorbs rounding errors of exact ratios).
+        double neededSubSteps = std::ceil(substepRate / Insight::TICK_RATE - 1e-9);
+        if (variables.count(Switch::maxSubSteps) > 0) {
+            worldSettings.maxSubSteps = variables[Switch::maxSubSteps].as<unsigned>();
+            if (worldSettings.maxSubSteps == 0) {
+                throw std::invalid_argument("Option --maxSubSteps must be at least 1.");
+            }
+            if (worldSettings.maxSubSteps < neededSubSteps) {
+                std::cerr << "Warning: --maxSubSteps " << worldSettings.maxSubSteps << " is too low for --substepRate ";
+                std::cerr << substepRate << " (" << neededSubSteps << " substeps per tick). Simulated time will be lost." << std::endl;
+            }
+        } else {
+            if (neededSubSteps > MAX_DEFAULT_SUBSTEPS) {
+                throw std::invalid_argument("Option --substepRate is too high (set --maxSubSteps explicitly).");
+            }
+            worldSettings.maxSubSteps = std::max(1u, static_cast<unsigned>(neededSubSteps));
+        }
+        worldSettings.solverIterations = variables[Switch::solverIterations].as<unsigned>();
+        if (worldSettings.solverIterations == 0) {
+            throw std::invalid_argument("Option --solverIterations must be at least 1.");
+        }
         insightDir = variables[Switch::insightDir].as<std::string>();
         luaInit = variables[Switch::luaInit].as<std::vector<std::string>>();
+        if (!record.empty() && !replay.empty()) {
+            throw std::invalid_argument("Options --record and --replay can't be used together.");
+        }
         bool noDefaultInit = (variables.count(Switch::noDefaultInit) > 0);
-        if (!noDefaultInit) {
+        if (!replay.empty()) {
+            // The init scripts are executed from the record.
+            luaInit.clear();
+        } else if (!noDefaultInit) {
             boost::filesystem::path initFile(insightDir + "/init.lua");
             if (boost::filesystem::exists(initFile)) {
                 luaInit.push_back(initFile.generic_string());
@@ -570,11 +912,27 @@ public:
     bool help;
     /** Version requested. */
     bool version;
+    /** Run without graphic engine. */
+    bool headless;
+    /** File in which the simulation is recorded (empty if disabled). */
+    std::string record;
+    /** Recorded simulation to replay (empty if disabled). */
+    std::string replay;
+    /** Script to execute in batch mode (empty if none). */
+    std::string script;
+    /** Number of ticks to run in batch mode. */
+    unsigned steps;
+    /** Exit after the batch instead of starting the shell. */
+    bool exitAfterBatch;
+    /** Construction parameters of the world of the main scene. */
+    World::Settings worldSettings;
     /** List of scripts to execute when starting the program. */
     std::vector<std::string> luaInit;
     /** Framework base directory. */
     std::string insightDir;
 private:
+    /** Highest number of substeps per tick derived from --substepRate. */
+    static constexpr unsigned MAX_DEFAULT_SUBSTEPS = 1000;
     /** Object holding the options descriptions. */
     static const options_description description;
 
@@ -594,10 +952,20 @@ private:
         namespace po = boost::program_options;
         options_description result("Command line arguments");
         result.add_options()
+            (Switch::exit, "exits after --replay, --script & --steps instead of starting the shell.")
+            (Switch::headless, "runs the simulation without 3d window, as fast as possible.")
             (Switch::help, "prints this help message, and exits.")
             (Switch::insightDir, po::value<std::string>()->default_value(getBinaryDir(),"executable location"), "sets the framework base directory.")
             (Switch::luaInit, po::value<std::vector<std::string>>()->default_value(std::vector<std::string>(),""), "executes a Lua script when starting the program.")
             (Switch::noDefaultInit, "disables automatic execution of init.lua in the framework directory.")
+            (Switch::maxSubSteps, po::value<unsigned>(), "maximum number of physics substeps per tick of the main world (simulated time is lost beyond). Default: enough substeps for a whole tick.")
+            (Switch::physicsThreads, po::value<unsigned>()->default_value(1), "number of threads stepping the main world (requires Bullet built with BT_THREADSAFE if more than 1).")
+            (Switch::record, po::value<std::string>()->default_value(""), "records the simulation (commands & actions of the robots) into a file.")
+            (Switch::replay, po::value<std::string>()->default_value(""), "replays a recorded simulation as fast as possible, then starts the shell.")
+            (Switch::script, po::value<std::string>()->default_value(""), "executes a Lua script (after the init scripts) before starting the shell.")
+            (Switch::solverIterations, po::value<unsigned>()->default_value(10), "number of iterations of the constraint solver of the main world.")
+            (Switch::steps, po::value<unsigned>()->default_value(0), "runs this number of ticks after the script, as fast as possible.")
+            (Switch::substepRate, po::value<double>()->default_value(240), "number of physics substeps per simulated second in the main world (Hz).")
             (Switch::version, "prints version & license info and exits.")
         ;
         return result;
@@ -652,8 +1020,18 @@ int main(int argc, char** argv) {
             printHeader();
         } else {
             printHeader();
-            Insight insight(options.luaInit, options.insightDir);
-            insight.run();
+            Insight insight(options.luaInit, options.insightDir, options.headless, options.record, options.worldSettings);
+            if (!options.replay.empty()) {
+                insight.replay(options.replay);
+            }
+            if (!options.script.empty() || options.steps > 0) {
+                if (!insight.runBatch(options.script, options.steps)) {
+                    errCode = EXIT_FAILURE;
+                }
+            }
+            if (!options.exitAfterBatch) {
+                insight.run();
+            }
         }
     } catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
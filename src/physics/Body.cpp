@@ -16,57 +16,62 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <unordered_set>
+#include <algorithm>
 
 #include "Body.hpp"
 #include "lua/bindings/bullet.hpp"
 #include "lua/bindings/FundamentalTypes.hpp"
 #include "lua/bindings/luaVirtualClass/shared_ptr.hpp"
 #include "lua/types/LuaMethod.hpp"
+#include "MemoryPool.hpp"
 #include "units/BulletUnits.hpp"
 
-/** Custom implementation of btMotionState. */
+/**
+ * Custom implementation of btMotionState.
+ *
+ * Adds the body to the dirty list of its world when it moves: the world then
+ * publishes the new transforms of all moved bodies once per step.
+ */
 class Body::MotionState : public btMotionState {
-private:
-    /** List of listeners to inform of new object position & orientation. */
-    std::unordered_set<BodyMoveListener*> moveListener;
 public:
+    /**
+     * Creates a new motion state.
+     * @param owner Body using this motion state.
+     */
+    MotionState(Body& owner) : owner(owner) {
+
+    }
+
     void getWorldTransform(btTransform& worldTrans) const override {
         worldTrans.setIdentity();
     }
 
     void setWorldTransform(const btTransform& worldTrans) override {
-        for (auto listener: moveListener) {
-            listener->onBodyMove(worldTrans);
+        if (owner.worldUpdater != nullptr) {
+            owner.worldUpdater->onBodyMove(owner);
         }
     }
-
-    /**
-     * Adds a new listener for "move" events.
-     *
-     * @param listener The new listener.
-     */
-    void addListener(BodyMoveListener& listener) {
-        moveListener.insert(&listener);
-    }
-
-    /**
-     * Removes listener for "move" events.
-     *
-     * @param listener The listener to remove.
-     */
-    void removeListener(BodyMoveListener& listener) {
-        moveListener.erase(&listener);
-    }
+private:
+    /** Body using this motion state. */
+    Body& owner;
 };
 
 Body::Body(std::shared_ptr<Shape> shape) :
     shape(std::move(shape)),
-    motionState(std::make_unique<MotionState>()),
+    motionState(std::make_unique<MotionState>(*this)),
     body(toBulletUnits(this->shape->getMass()), motionState.get(), &this->shape->getBulletShape(), this->shape->getEngineInertia()),
     worldUpdater(nullptr)
 {
     setSleepingThresholds(Scalar<SI::Speed>(0.01), Scalar<SI::AngularVelocity>(SIMD_PI / 10.0));
+    body.setUserPointer(this);
+    // Same default filter as btDiscreteDynamicsWorld::addRigidBody().
+    if (body.isStaticOrKinematicObject()) {
+        collisionGroup = btBroadphaseProxy::StaticFilter;
+        collisionMask = btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter;
+    } else {
+        collisionGroup = btBroadphaseProxy::DefaultFilter;
+        collisionMask = btBroadphaseProxy::AllFilter;
+    }
 }
 
 const btTransform& Body::getEngineTransform() const {
@@ -123,6 +128,71 @@ void Body::setLinearVelocity(const Vector3<SI::Speed>& velocity) {
     body.activate();
 }
 
+void Body::setCollisionFilter(int group, int mask) {
+    collisionGroup = group;
+    collisionMask = mask;
+}
+
+void Body::disableCollisionsWith(Body& other) {
+    if (&other != this && canCollideWith(other)) {
+        collisionExceptions.push_back(&other);
+        other.collisionExceptions.push_back(this);
+    }
+}
+
+bool Body::canCollideWith(const Body& other) const {
+    return std::find(collisionExceptions.begin(), collisionExceptions.end(), &other) == collisionExceptions.end();
+}
+
+std::shared_ptr<Body> Body::clone() const {
+    auto result = makePooled<Body>(shape);
+    result->setCollisionFilter(collisionGroup, collisionMask);
+    result->copyState(*this);
+    return result;
+}
+
+void Body::copyState(const Body& source) {
+    const btRigidBody& sourceBody = source.body;
+    body.setCenterOfMassTransform(sourceBody.getCenterOfMassTransform());
+    body.setInterpolationWorldTransform(sourceBody.getInterpolationWorldTransform());
+    body.setLinearVelocity(sourceBody.getLinearVelocity());
+    body.setAngularVelocity(sourceBody.getAngularVelocity());
+    body.setInterpolationLinearVelocity(sourceBody.getInterpolationLinearVelocity());
+    body.setInterpolationAngularVelocity(sourceBody.getInterpolationAngularVelocity());
+    body.forceActivationState(sourceBody.getActivationState());
+    body.setDeactivationTime(sourceBody.getDeactivationTime());
+    motionState->setWorldTransform(body.getWorldTransform());
+}
+
+void Body::saveState(btRigidBodyData& data, btSerializer& serializer) const {
+    body.serialize(&data, &serializer);
+}
+
+void Body::loadState(const btRigidBodyData& data) {
+    const auto& objectData = data.m_collisionObjectData;
+    btTransform transform;
+    transform.deSerialize(objectData.m_worldTransform);
+    btTransform interpolationTransform;
+    interpolationTransform.deSerialize(objectData.m_interpolationWorldTransform);
+    btVector3 linearVelocity, angularVelocity;
+    linearVelocity.deSerialize(data.m_linearVelocity);
+    angularVelocity.deSerialize(data.m_angularVelocity);
+    btVector3 interpolationLinearVelocity, interpolationAngularVelocity;
+    interpolationLinearVelocity.deSerialize(objectData.m_interpolationLinearVelocity);
+    interpolationAngularVelocity.deSerialize(objectData.m_interpolationAngularVelocity);
+
+    body.setCenterOfMassTransform(transform);
+    body.setInterpolationWorldTransform(interpolationTransform);
+    body.setLinearVelocity(linearVelocity);
+    body.setAngularVelocity(angularVelocity);
+    body.setInterpolationLinearVelocity(interpolationLinearVelocity);
+    body.setInterpolationAngularVelocity(interpolationAngularVelocity);
+    body.clearForces();
+    body.forceActivationState(objectData.m_activationState1);
+    body.setDeactivationTime(objectData.m_deactivationTime);
+    motionState->setWorldTransform(transform);
+}
+
 btRigidBody& Body::getBulletBody() {
     return body;
 }
@@ -172,16 +242,14 @@ std::unique_ptr<Body> Body::luaGetFromTable(LuaTable& table) {
     return std::make_unique<Body>(shape);
 }
 
-void Body::addMoveListener(BodyMoveListener& listener) const {
-    motionState->addListener(listener);
-}
-
-void Body::removeMoveListener(BodyMoveListener& listener) const {
-    motionState->removeListener(listener);
+Body::~Body() {
+    // The memory of this body can be reused by another body: the exceptions must not outlive it.
+    for (Body* other : collisionExceptions) {
+        auto& exceptions = other->collisionExceptions;
+        exceptions.erase(std::find(exceptions.begin(), exceptions.end(), this));
+    }
 }
 
-Body::~Body() = default;
-
 void Body::setSleepingThresholds(Scalar<SI::Speed> linear, Scalar<SI::AngularVelocity> angular) {
     body.setSleepingThresholds(toBulletUnits(linear), toBulletUnits(angular));
 }
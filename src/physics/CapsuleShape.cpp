@@ -0,0 +1,122 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CapsuleShape.hpp"
+#include "lua/bindings/bullet.hpp"
+#include "lua/bindings/FundamentalTypes.hpp"
+#include "lua/types/LuaNativeString.hpp"
+#include "ShapeCache.hpp"
+#include "units/BulletUnits.hpp"
+
+CapsuleShape::CapsuleShape(Scalar<SI::Mass> mass, Scalar<SI::Length> radius, Scalar<SI::Length> halfHeight) :
+    Shape(mass),
+    shape(toBulletUnits(radius), 2*toBulletUnits(halfHeight))
+{
+
+}
+
+/**
+ * Computes the volume of a capsule.
+ * @param[in] radius Radius of the capsule.
+ * @param[in] halfHeight Half length of the cylindric part of the capsule.
+ * @return The volume of the capsule.
+ */
+static Scalar<SI::Volume> capsuleVolume(Scalar<SI::Length> radius, Scalar<SI::Length> halfHeight) {
+    return SIMD_PI*radius*radius*(btScalar(2)*halfHeight + btScalar(4)/btScalar(3)*radius);
+}
+
+CapsuleShape::CapsuleShape(Scalar<SI::Density> density, Scalar<SI::Length> radius, Scalar<SI::Length> halfHeight) :
+    CapsuleShape(capsuleVolume(radius, halfHeight)*density, radius, halfHeight)
+{
+
+}
+
+CapsuleShape::~CapsuleShape() = default;
+
+Scalar<SI::Length> CapsuleShape::getRadius() const {
+    return fromBulletValue<SI::Length>(shape.getRadius());
+}
+
+Scalar<SI::Length> CapsuleShape::getHalfHeight() const {
+    return fromBulletValue<SI::Length>(shape.getHalfHeight());
+}
+
+btCollisionShape& CapsuleShape::getBulletShape() {
+    return shape;
+}
+
+const btCollisionShape& CapsuleShape::getBulletShape() const {
+    return shape;
+}
+
+btVector3 CapsuleShape::getEngineInertia() const {
+    btScalar radius = shape.getRadius();
+    btScalar height = 2*shape.getHalfHeight();
+    btScalar cylinderVolume = SIMD_PI*radius*radius*height;
+    btScalar spheresVolume = SIMD_PI*radius*radius*radius*btScalar(4)/btScalar(3);
+    btScalar density = toBulletUnits(mass) / (cylinderVolume + spheresVolume);
+    btScalar cylinderMass = density * cylinderVolume;
+    btScalar spheresMass = density * spheresVolume;
+    btScalar radius2 = radius*radius;
+    // the 2 half spheres are offset from the center by halfHeight + 3/8*radius (their center of mass).
+    btScalar axial = cylinderMass*radius2/2 + spheresMass*radius2*btScalar(2)/btScalar(5);
+    btScalar transverse = cylinderMass*(height*height/12 + radius2/4)
+            + spheresMass*(radius2*btScalar(2)/btScalar(5) + height*height/4 + btScalar(3)/btScalar(8)*height*radius);
+    return btVector3(transverse, axial, transverse);
+}
+
+void CapsuleShape::draw(ShapeDrawer& drawer, const btTransform& transform) const {
+    drawer.drawCapsule(transform, shape.getRadius(), shape.getHalfHeight());
+}
+
+int CapsuleShape::luaIndex(const std::string& memberName, LuaStateView& state) {
+    int result = 1;
+    if (memberName=="radius") {
+        state.push<Scalar<SI::Length>>(getRadius());
+    } else if (memberName=="halfHeight") {
+        state.push<Scalar<SI::Length>>(getHalfHeight());
+    } else {
+        result = Shape::luaIndex(memberName, state);
+    }
+    return result;
+}
+
+std::shared_ptr<CapsuleShape> CapsuleShape::luaGetFromTable(LuaTable& table) {
+    auto radius = table.get<LuaNativeString,Scalar<SI::Length>>("radius");
+    auto halfHeight = table.get<LuaNativeString,Scalar<SI::Length>>("halfHeight");
+    Scalar<SI::Mass> mass;
+    if (table.has<LuaNativeString>("mass")) {
+        mass = table.get<LuaNativeString,Scalar<SI::Mass>>("mass");
+    } else {
+        auto density = table.get<LuaNativeString,Scalar<SI::Density>>("density");
+        mass = density * capsuleVolume(radius, halfHeight);
+    }
+    return makeShared(mass, radius, halfHeight);
+}
+
+std::shared_ptr<CapsuleShape> CapsuleShape::makeShared(Scalar<SI::Mass> mass, Scalar<SI::Length> radius, Scalar<SI::Length> halfHeight) {
+    ShapeCache::Key key("Capsule");
+    key.add(toBulletUnits(mass)).add(toBulletUnits(radius)).add(toBulletUnits(halfHeight));
+    return ShapeCache::global().get<CapsuleShape>(key, [&]() -> std::shared_ptr<CapsuleShape> {
+        return std::make_shared<CapsuleShape>(mass, radius, halfHeight);
+    });
+}
+
+std::shared_ptr<CapsuleShape> CapsuleShape::makeShared(Scalar<SI::Density> density, Scalar<SI::Length> radius, Scalar<SI::Length> halfHeight) {
+    return makeShared(capsuleVolume(radius, halfHeight) * density, radius, halfHeight);
+}
@@ -21,6 +21,7 @@
 #include "lua/bindings/luaVirtualClass/shared_ptr.hpp"
 #include "lua/types/LuaNativeString.hpp"
 #include "CompoundShape.hpp"
+#include "ShapeCache.hpp"
 #include "units/Scalar.hpp"
 
 CompoundShape::CompoundShape(const std::vector<ChildInfo>& constructionInfo) {
@@ -51,7 +52,7 @@ void CompoundShape::draw(ShapeDrawer& drawer, const btTransform& transform) cons
     }
 }
 
-std::unique_ptr<CompoundShape> CompoundShape::luaGetFromTable(LuaTable& table) {
+std::shared_ptr<CompoundShape> CompoundShape::luaGetFromTable(LuaTable& table) {
     using Str = LuaNativeString;
     std::vector<ChildInfo> children;
     LuaTable childrenTable = table.get<Str, LuaTable>("children");
@@ -63,5 +64,15 @@ std::unique_ptr<CompoundShape> CompoundShape::luaGetFromTable(LuaTable& table) {
         };
         children.push_back(child);
     }
-    return std::make_unique<CompoundShape>(children);
+    return makeShared(children);
+}
+
+std::shared_ptr<CompoundShape> CompoundShape::makeShared(const std::vector<ChildInfo>& constructionInfo) {
+    ShapeCache::Key key("Compound");
+    for (const ChildInfo& child : constructionInfo) {
+        key.add(*child.shape).add(toBulletUnits(child.transform));
+    }
+    return ShapeCache::global().get<CompoundShape>(key, [&]() -> std::shared_ptr<CompoundShape> {
+        return std::make_shared<CompoundShape>(constructionInfo);
+    });
 }
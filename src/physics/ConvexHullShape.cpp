@@ -18,20 +18,38 @@
 
 #include "ConvexHullShape.hpp"
 #include "ConvexMesh.hpp"
+#include "ShapeCache.hpp"
+#include "lua/LuaException.hpp"
 #include "lua/bindings/bullet.hpp"
 #include "lua/bindings/FundamentalTypes.hpp"
+#include "lua/helpers/LuaCount.hpp"
 #include "lua/types/LuaNativeString.hpp"
 #include "units/BulletUnits.hpp"
 
-ConvexHullShape::ConvexHullShape(Scalar<SI::Mass> mass, const std::vector<Vector3<SI::Length>>& vertices) :
+ConvexHullShape::ConvexHullShape(Scalar<SI::Mass> mass, const std::vector<Vector3<SI::Length>>& vertices, std::size_t maxVertices) :
     Shape(mass)
 {
-    for (auto& vertex : vertices) {
-        shape.addPoint(toBulletUnits(vertex), false);
+    if (maxVertices == 0) {
+        for (auto& vertex : vertices) {
+            shape.addPoint(toBulletUnits(vertex), false);
+        }
+    } else {
+        std::vector<btVector3> points;
+        points.reserve(vertices.size());
+        for (auto& vertex : vertices) {
+            points.push_back(toBulletUnits(vertex));
+        }
+        ConvexMesh hull(points, maxVertices);
+        for (const btVector3& vertex : hull.getVertices()) {
+            shape.addPoint(vertex, false);
+        }
+        simplificationError = hull.getError();
     }
     shape.recalcLocalAabb();
     // TODO: proper center of mass & inertia matrix computation.
     shape.optimizeConvexHull();
+    // Faces & edges used by btPolyhedralContactClipping (full contact manifolds in a single step).
+    shape.initializePolyhedralFeatures();
 }
 
 ConvexHullShape::~ConvexHullShape() = default;
@@ -45,21 +63,61 @@ const btCollisionShape& ConvexHullShape::getBulletShape() const {
 }
 
 void ConvexHullShape::draw(ShapeDrawer& drawer, const btTransform& transform) const {
-    std::vector<btVector3> vertices(shape.getNumVertices());
-    for (int index = 0; index < shape.getNumVertices(); index++) {
-        shape.getVertex(index, vertices[index]);
+    drawer.drawMesh(transform, getRenderMesh());
+}
+
+Scalar<SI::Length> ConvexHullShape::getSimplificationError() const {
+    return fromBulletValue<SI::Length>(simplificationError);
+}
+
+int ConvexHullShape::luaIndex(const std::string& memberName, LuaStateView& state) {
+    int result = 1;
+    if (memberName=="simplificationError") {
+        state.push<Scalar<SI::Length>>(getSimplificationError());
+    } else {
+        result = Shape::luaIndex(memberName, state);
     }
-    ConvexMesh mesh(std::move(vertices));
-    mesh.addMargin(shape.getMargin());
-    drawer.drawMesh(transform, mesh);
+    return result;
+}
+
+const std::shared_ptr<const ConvexMesh>& ConvexHullShape::getRenderMesh() const {
+    std::call_once(renderMeshFlag, [this]() {
+        std::vector<btVector3> vertices(shape.getNumVertices());
+        for (int index = 0; index < shape.getNumVertices(); index++) {
+            shape.getVertex(index, vertices[index]);
+        }
+        auto mesh = std::make_shared<ConvexMesh>(std::move(vertices));
+        mesh->addMargin(shape.getMargin());
+        renderMesh = std::move(mesh);
+    });
+    return renderMesh;
 }
 
-std::unique_ptr<ConvexHullShape> ConvexHullShape::luaGetFromTable(LuaTable& table) {
+std::shared_ptr<ConvexHullShape> ConvexHullShape::luaGetFromTable(LuaTable& table) {
     auto mass = table.get<LuaNativeString,Scalar<SI::Mass>>("mass");
     LuaTable verticesTable = table.get<LuaNativeString,LuaTable>("vertices");
     std::vector<Vector3<SI::Length>> vertices;
     for (unsigned i = 1; verticesTable.has<float>(i); i++) {
         vertices.push_back(verticesTable.get<float,Vector3<SI::Length>>(i));
     }
-    return std::make_unique<ConvexHullShape>(mass, vertices);
+    std::size_t maxVertices = 0;
+    if (table.has<LuaNativeString>("maxVertices")) {
+        double value = table.get<LuaNativeString,double>("maxVertices");
+        if (!isLuaCount<std::size_t>(value, 4)) {
+            throw LuaException("ConvexHull: 'maxVertices' must be an integer, at least 4.");
+        }
+        maxVertices = static_cast<std::size_t>(value);
+    }
+    return makeShared(mass, vertices, maxVertices);
+}
+
+std::shared_ptr<ConvexHullShape> ConvexHullShape::makeShared(Scalar<SI::Mass> mass, const std::vector<Vector3<SI::Length>>& vertices, std::size_t maxVertices) {
+    ShapeCache::Key key("ConvexHull");
+    key.add(toBulletUnits(mass)).add(maxVertices);
+    for (const auto& vertex : vertices) {
+        key.add(toBulletUnits(vertex));
+    }
+    return ShapeCache::global().get<ConvexHullShape>(key, [&]() -> std::shared_ptr<ConvexHullShape> {
+        return std::make_shared<ConvexHullShape>(mass, vertices, maxVertices);
+    });
 }
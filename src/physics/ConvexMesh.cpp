@@ -16,8 +16,10 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <array>
 #include <limits>
+#include <stdexcept>
 #include <vector>
 
 #include "ConvexMesh.hpp"
@@ -49,220 +51,544 @@ Iterator maximize_element(Iterator first, Iterator last, Operation function) {
 }
 
 /**
- * Gets the next vertex in a triangle, in counter clockwise order (seen from the outside).
+ * Computes the distance between a point and a triangle.
  *
- * This function assumes that vertices are stored in the same order in the triangle.
- *
- * @param face Triangle containing the vertices in CCW order.
- * @param vertex A vertex of the given triangle.
- * @return The next vertex in CCW order, seen from outside the mesh.
+ * @param point Point to evaluate.
+ * @param a First vertex of the triangle.
+ * @param b Second vertex of the triangle.
+ * @param c Third vertex of the triangle.
+ * @return The distance between the point and the closest point of the triangle.
  */
-static const btVector3& getNextVertexCCW(const MeshTriangle& face, const btVector3& vertex) {
-    const auto& vertices = face.getVertices();
-    auto it = std::find_if(vertices.begin(), vertices.end(), [&](const btVector3& value) -> bool {
-        return &vertex == &value;
-    });
-    unsigned index = std::distance(vertices.begin(), it);
-    return vertices[(index+1)%vertices.size()];
-}
-
-/**
- * Sorts the faces containing the given vertex in clockwise order (seen from the outside).
- *
- * This must be the full set of faces containing this vertex: for a given triangle in the set,
- * there must be exactly 2 adjacent triangles.
- *
- * @param vertex Vertex shared by all the faces
- * @param faces Set of faces.
- * @return The list of faces, sorted in clockwise order.
- */
-static std::vector<const MeshTriangle*> sortFacesCW(const btVector3& vertex, const std::unordered_set<const MeshTriangle*>& faces) {
-    std::vector<const MeshTriangle*> result;
-    // generate the circular list.
-    result.reserve(faces.size());
-    auto current = faces.begin();
-    do {
-        const MeshTriangle& face = **current;
-        const btVector3& nextVertex = getNextVertexCCW(face, vertex);
-        result.emplace_back(*current);
-        current = std::find_if(faces.begin(), faces.end(), [&](const MeshTriangle* value) -> bool {
-            return (value != &face) && value->hasVertex(nextVertex);
-        });
-    } while (*current != result[0]);
-    return result;
-}
-
-/**
- * Returns the angle of a vertex in a triangle.
- *
- * @param triangle Triangle containing the specified vertex.
- * @param vertex Vertex in the given triangle.
- * @return The angle defined by the 2 edges of the given vertex in the triangle.
- */
-static btScalar angleInTriangle(const MeshTriangle& triangle, const btVector3* vertex) {
-    const auto& vertices = triangle.getVertices();
-    auto it = std::find_if(vertices.begin(), vertices.end(), [vertex](const btVector3& value) -> bool {
-        return vertex == &value;
-    });
-    auto index = std::distance(vertices.begin(), it);
-    return btAngle(vertices[(index+1)%3] - *it, vertices[(index+2)%3] - *it);
+static btScalar triangleDistance(const btVector3& point, const btVector3& a, const btVector3& b, const btVector3& c) {
+    const btVector3 ab = b - a;
+    const btVector3 ac = c - a;
+    const btVector3 ap = point - a;
+    btScalar d1 = ab.dot(ap);
+    btScalar d2 = ac.dot(ap);
+    if (d1 <= 0 && d2 <= 0) {
+        return ap.length();
+    }
+    const btVector3 bp = point - b;
+    btScalar d3 = ab.dot(bp);
+    btScalar d4 = ac.dot(bp);
+    if (d3 >= 0 && d4 <= d3) {
+        return bp.length();
+    }
+    btScalar vc = d1*d4 - d3*d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+        return (ap - (d1 / (d1 - d3)) * ab).length();
+    }
+    const btVector3 cp = point - c;
+    btScalar d5 = ab.dot(cp);
+    btScalar d6 = ac.dot(cp);
+    if (d6 >= 0 && d5 <= d6) {
+        return cp.length();
+    }
+    btScalar vb = d5*d2 - d1*d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+        return (ap - (d2 / (d2 - d6)) * ac).length();
+    }
+    btScalar va = d3*d6 - d5*d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+        return (bp - ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b)).length();
+    }
+    btScalar denominator = 1 / (va + vb + vc);
+    return (ap - (vb * denominator) * ab - (vc * denominator) * ac).length();
 }
 
 /**
- * Partition an ordered set of faces according to the angle with their neighbours.
+ * Convex hull builder, implementing the Quickhull algorithm.
  *
- * Two adjacent faces will be placed in the same partition if the angle between
- * their normal vectors is inferior to maxAngle.
+ * Every face of the hull under construction owns a conflict list: the input points
+ * outside of this face (each point is in at most one list). The farthest point of a conflict
+ * list is merged into the hull by removing all the faces it can see, and connecting it
+ * to the horizon. Faces & points are only referenced by their index.
  *
- * The ordered set is circular: the last item in the vector can be placed in the same
- * partition as the first item.
+ * With a vertex budget, points are merged in decreasing order of distance to the hull:
+ * stopping early gives a simplified hull, inside the exact one. Otherwise the most
+ * recent faces are processed first (better memory locality).
  *
- * @param sortedFaces Circular vector of faces.
- * @param maxAngle Maximum angles between the normals of adjacent triangles.
- * @return A vector of the partitions.
+ * Visibility is tested without tolerance: with rounding errors on nearly coplanar faces,
+ * the faces visible from a point might not form a disk. Such a point is skipped, and its
+ * distance to the hull is included in getError().
  */
-static std::vector<std::unordered_set<const MeshTriangle*>>
-partitionFacesByAngle(const std::vector<const MeshTriangle*>& sortedFaces, btScalar maxAngle) {
-    btScalar minCos = btCos(maxAngle);
-    auto shouldMerge = [minCos](const MeshTriangle* a, const MeshTriangle* b) -> bool {
-        return a->getNormal().dot(b->getNormal()) > minCos;
-    };
-    unsigned i = 0;
-    std::vector<std::unordered_set<const MeshTriangle*>> partitions;
-    while (i < sortedFaces.size()) {
-        const MeshTriangle* current = sortedFaces[i];
-        auto& partition = partitions.emplace_back();
-        partition.insert(current);
-        i++;
-        while ((i < sortedFaces.size()) && shouldMerge(current, sortedFaces[i])) {
-            current = sortedFaces[i];
-            partition.insert(current);
-            i++;
+class Quickhull {
+public:
+    /**
+     * Computes the convex hull of a set of points.
+     *
+     * @param points Input points (at least 4, not coplanar).
+     * @param maxVertices Maximum number of vertices of the hull (at least 4).
+     */
+    Quickhull(const std::vector<btVector3>& points, std::size_t maxVertices) :
+        points(points),
+        farthestFirst(maxVertices < points.size()),
+        newFaceFrom(points.size()),
+        newFaceTo(points.size()),
+        horizonNext(points.size(), NONE)
+    {
+        if (points.size() < 4) {
+            throw std::invalid_argument("A convex hull requires at least 4 vertices.");
+        }
+        if (maxVertices < 4) {
+            throw std::invalid_argument("A convex hull requires a budget of at least 4 vertices.");
+        }
+        btVector3 maxAbs(0,0,0);
+        for (const btVector3& point : points) {
+            maxAbs.setMax(point.absolute());
+        }
+        epsilon = 3 * SIMD_EPSILON * (maxAbs.x() + maxAbs.y() + maxAbs.z());
+        buildSimplex();
+        std::size_t vertexCount = 4;
+        while (!pendingFaces.empty() && vertexCount < maxVertices) {
+            PendingFace pending = popPending();
+            const Face& face = faces[pending.face];
+            if (face.alive && face.generation == pending.generation) {
+                if (addPoint(pending.face, pending.eye)) {
+                    vertexCount++;
+                }
+            }
         }
+        computeError();
     }
-    if (partitions.size() > 2 && shouldMerge(sortedFaces[0], sortedFaces[sortedFaces.size()-1])) {
-        auto& lastPart = partitions[partitions.size()-1];
-        partitions[0].insert(lastPart.begin(), lastPart.end());
-        partitions.pop_back();
+
+    /**
+     * Gets an upper bound of the distance between the input points and the computed hull.
+     * @return 0 for an exact hull, or the maximum error introduced by the vertex budget (or by skipped points).
+     */
+    btScalar getError() const {
+        return error;
     }
-    return partitions;
-}
 
-/** Edge of a ConvexMesh. */
-class MeshEdge {
-public:
     /**
-     * Creates a new edge.
+     * Writes the computed hull into flat arrays.
      *
-     * The vertices might be reordered internally.
+     * Vertices are renumbered: only the points of the hull are kept.
      *
-     * @param v1 First vertex of the edge.
-     * @param v2 Second vertex of the edge;
+     * @param[out] vertices Vertices of the hull.
+     * @param[out] indices Vertex indices of the triangles (CCW seen from outside).
+     * @param[out] normals Outward normal of each triangle.
      */
-    MeshEdge(const btVector3& v1, const btVector3& v2) :
-        vertices{v1,v2}
-    {
-        if (&v1 > &v2) {
-            std::swap(vertices[0],vertices[1]);
+    void getMesh(std::vector<btVector3>& vertices, std::vector<unsigned>& indices, std::vector<btVector3>& normals) const {
+        std::vector<unsigned> newIndices(points.size(), NONE);
+        vertices.clear();
+        indices.clear();
+        normals.clear();
+        for (const Face& face : faces) {
+            if (face.alive) {
+                for (unsigned vertex : face.vertices) {
+                    if (newIndices[vertex] == NONE) {
+                        newIndices[vertex] = vertices.size();
+                        vertices.push_back(points[vertex]);
+                    }
+                    indices.push_back(newIndices[vertex]);
+                }
+                normals.push_back(face.normal);
+            }
         }
     }
+private:
+    /** Index used for "no face" or "no vertex". */
+    static constexpr unsigned NONE = std::numeric_limits<unsigned>::max();
+
+    /** Triangle of the hull under construction. */
+    struct Face {
+        /** Indices of the 3 vertices, in CCW order seen from outside. */
+        std::array<unsigned,3> vertices;
+        /** Faces sharing the edges of this face: <code>neighbours[i]</code> is across <code>vertices[i] -> vertices[(i+1)%3]</code>. */
+        std::array<unsigned,3> neighbours;
+        /** Outward unit normal. */
+        btVector3 normal;
+        /** <code>d</code> coefficient of the plane equation of this face. */
+        btScalar offset;
+        /** Points outside of this face, not merged into the hull yet. */
+        std::vector<unsigned> conflicts;
+        /** False if this face was removed from the hull (its slot can be reused). */
+        bool alive;
+        /** Last iteration in which this face was found visible. */
+        unsigned visited;
+        /** Number of times this slot was (re)used. */
+        unsigned generation = 0;
+
+        /**
+         * Computes the signed distance of a point to the plane of this face.
+         * @param point Point to evaluate.
+         * @return The signed distance (positive outside).
+         */
+        btScalar distance(const btVector3& point) const {
+            return normal.dot(point) + offset;
+        }
+    };
+
+    /** Edge between a visible face and a face kept in the hull. */
+    struct HorizonEdge {
+        /** First vertex (order of the visible face). */
+        unsigned from;
+        /** Second vertex (order of the visible face). */
+        unsigned to;
+        /** Face kept on the other side of this edge. */
+        unsigned outsideFace;
+    };
+
+    /** Face with a non empty conflict list, waiting to be processed. */
+    struct PendingFace {
+        /** Distance of the farthest point of the conflict list. */
+        btScalar distance;
+        /** Index of the face. */
+        unsigned face;
+        /** Index of the farthest point of the conflict list. */
+        unsigned eye;
+        /** Generation of the face slot when this object was created. */
+        unsigned generation;
+
+        /**
+         * Orders pending faces by distance.
+         * @param other Pending face to compare to this object.
+         * @return True if this object must be processed after other.
+         */
+        bool operator<(const PendingFace& other) const {
+            return distance < other.distance;
+        }
+    };
+
+    /** Input points. */
+    const std::vector<btVector3>& points;
+    /** True if pendingFaces is a heap (farthest point first), false for a stack. */
+    bool farthestFirst;
+    /** Distance under which a point is considered to be on a plane (for conflict lists). */
+    btScalar epsilon;
+    /** Faces of the hull (including dead slots). */
+    std::vector<Face> faces;
+    /** Indices of the dead slots in faces. */
+    std::vector<unsigned> freeFaces;
+    /** Faces with a non empty conflict list (might contain removed faces). */
+    std::vector<PendingFace> pendingFaces;
+    /** Result of getError(). */
+    btScalar error = 0;
+    /** Maximum distance between a skipped point and the hull. */
+    btScalar skippedError = 0;
+    /** Current iteration number (see Face::visited). */
+    unsigned iteration = 0;
+
+    /** Scratch list of the faces visible from the current point. */
+    std::vector<unsigned> visibleFaces;
+    /** Scratch list of the horizon edges of the current point. */
+    std::vector<HorizonEdge> horizon;
+    /** Scratch list of the faces created for the current point. */
+    std::vector<unsigned> newFaces;
+    /** Scratch map (vertex index -> new face) for the new face starting at this horizon vertex. */
+    std::vector<unsigned> newFaceFrom;
+    /** Scratch map (vertex index -> new face) for the new face ending at this horizon vertex. */
+    std::vector<unsigned> newFaceTo;
+    /** Scratch map (vertex index -> next horizon vertex), NONE outside of isSimpleHorizon(). */
+    std::vector<unsigned> horizonNext;
 
     /**
-     * Compares the address of the stored vertices (NOT a value comparison).
+     * Creates a new face (neighbours are not set).
      *
-     * @param other Other edge to compare to this object.
-     * @return The result of the comparison.
+     * @param a First vertex.
+     * @param b Second vertex.
+     * @param c Third vertex.
+     * @return The index of the new face.
      */
-    bool operator==(const MeshEdge& other) const {
-        bool result = true;
-        for (unsigned i = 0; i < vertices.size(); i++) {
-            result = result && (&other.vertices[i].get() == &vertices[i].get());
+    unsigned addFace(unsigned a, unsigned b, unsigned c) {
+        unsigned result;
+        if (freeFaces.empty()) {
+            result = faces.size();
+            faces.emplace_back();
+        } else {
+            result = freeFaces.back();
+            freeFaces.pop_back();
         }
+        Face& face = faces[result];
+        face.vertices = {a, b, c};
+        face.neighbours = {NONE, NONE, NONE};
+        face.normal = (points[b] - points[a]).cross(points[c] - points[a]).normalize();
+        face.offset = -face.normal.dot(points[a]);
+        face.alive = true;
+        face.visited = 0;
+        face.generation++;
         return result;
     }
 
     /**
-     * Gets the first vertex of this edge.
-     * @return The first vertex of this edge.
+     * Schedules the processing of a face, if its conflict list is not empty.
+     * @param faceIndex Index of the face.
      */
-    const btVector3& first() const {
-        return vertices[0];
+    void pushPending(unsigned faceIndex) {
+        const Face& face = faces[faceIndex];
+        if (!face.conflicts.empty()) {
+            auto eye = maximize_element(face.conflicts.begin(), face.conflicts.end(), [&](unsigned point) -> btScalar {
+                return face.distance(points[point]);
+            });
+            pendingFaces.push_back({face.distance(points[*eye]), faceIndex, *eye, face.generation});
+            if (farthestFirst) {
+                std::push_heap(pendingFaces.begin(), pendingFaces.end());
+            }
+        }
     }
 
     /**
-     * Gets the second vertex of this edge.
-     * @return The second vertex of this edge.
+     * Removes the next face to process from pendingFaces.
+     * @return The next face to process.
      */
-    const btVector3& second() const {
-        return vertices[1];
+    PendingFace popPending() {
+        if (farthestFirst) {
+            std::pop_heap(pendingFaces.begin(), pendingFaces.end());
+        }
+        PendingFace result = pendingFaces.back();
+        pendingFaces.pop_back();
+        return result;
     }
 
-    /** Custom hash implementation. */
-    struct Hash {
-        /**
-         * Hash the pointers (NOT the values) of the vertices of this edge
-         *
-         * @param object Edge to hash.
-         * @return The computed hash value.
-         */
-        std::size_t operator()(const MeshEdge& object) const {
-            std::size_t result = 0;
-            for (const btVector3& index : object.vertices) {
-                result ^= std::hash<const btVector3*>()(&index);
+    /** Computes the value of getError(), from the points left in the conflict lists. */
+    void computeError() {
+        error = skippedError;
+        for (const Face& face : faces) {
+            if (face.alive) {
+                const btVector3& a = points[face.vertices[0]];
+                const btVector3& b = points[face.vertices[1]];
+                const btVector3& c = points[face.vertices[2]];
+                for (unsigned point : face.conflicts) {
+                    error = std::max(error, triangleDistance(points[point], a, b, c));
+                }
             }
-            return result;
         }
-    };
-private:
-    /** The 2 vertices of this edge. */
-    std::array<std::reference_wrapper<const btVector3>, 2> vertices;
-};
+    }
 
-ConvexMesh::ConvexMesh(std::vector<btVector3>&& inputVertices) :
-    vertices(inputVertices),
-    center(0,0,0)
-{
-    if (inputVertices.size() < 4) {
-        throw std::invalid_argument("A convex hull requires at least 4 vertices.");
+    /**
+     * Adds a point to the conflict list of the farthest face it can see.
+     *
+     * @param point Index of the point.
+     * @param candidates Faces which might see this point.
+     */
+    void assignPoint(unsigned point, const std::vector<unsigned>& candidates) {
+        unsigned bestFace = NONE;
+        btScalar bestDistance = epsilon;
+        for (unsigned faceIndex : candidates) {
+            btScalar distance = faces[faceIndex].distance(points[point]);
+            if (distance > bestDistance) {
+                bestDistance = distance;
+                bestFace = faceIndex;
+            }
+        }
+        if (bestFace != NONE) {
+            faces[bestFace].conflicts.push_back(point);
+        }
     }
-    std::vector<std::reference_wrapper<const btVector3>> firstVertices(4, *vertices.begin());
-
-    // first 2 vertices: min & max X coordinate
-    auto pair = std::minmax_element(vertices.begin(), vertices.end(), [](const btVector3& a, const btVector3& b) -> bool {
-        return a.x() < b.x();
-    });
-    firstVertices[0] = *pair.first;
-    firstVertices[1] = *pair.second;
-
-    // 3rd vertex: farthest vertex from the line defined by the first 2 vertices.
-    const btVector3 direction = (firstVertices[1] - firstVertices[0]).normalize();
-    firstVertices[2] = *maximize_element(vertices.begin(), vertices.end(), [&](const btVector3& value) -> btScalar {
-        const btVector3 delta = value - firstVertices[0];
-        return (delta-direction.dot(delta)*direction).length2();
-    });
-
-    // 4th vertex: farthest vertex from the plane defined by the first 3 vertices.
-    MeshTriangle firstTriangle(firstVertices[0], firstVertices[1], firstVertices[2]);
-    firstVertices[3] = *maximize_element(vertices.begin(), vertices.end(), [&](const btVector3& value) -> btScalar {
-        return btFabs(firstTriangle.offsetOff(value));
-    });
-
-    for (auto& vertex : firstVertices) {
-        center+= vertex;
+
+    /** Builds the initial tetrahedron, and the conflict lists of its faces. */
+    void buildSimplex() {
+        // first 2 vertices: extreme points along the axis with the largest extent.
+        std::array<unsigned,3> minIndex = {0,0,0};
+        std::array<unsigned,3> maxIndex = {0,0,0};
+        for (unsigned index = 1; index < points.size(); index++) {
+            for (int axis = 0; axis < 3; axis++) {
+                if (points[index][axis] < points[minIndex[axis]][axis]) {
+                    minIndex[axis] = index;
+                }
+                if (points[index][axis] > points[maxIndex[axis]][axis]) {
+                    maxIndex[axis] = index;
+                }
+            }
+        }
+        int axis = 0;
+        for (int current = 1; current < 3; current++) {
+            btScalar extent = points[maxIndex[current]][current] - points[minIndex[current]][current];
+            if (extent > points[maxIndex[axis]][axis] - points[minIndex[axis]][axis]) {
+                axis = current;
+            }
+        }
+        std::array<unsigned,4> simplex;
+        simplex[0] = minIndex[axis];
+        simplex[1] = maxIndex[axis];
+        const btVector3& origin = points[simplex[0]];
+        if (points[simplex[1]][axis] - origin[axis] <= epsilon) {
+            throw std::invalid_argument("Degenerate convex hull: all vertices are identical.");
+        }
+
+        // 3rd vertex: farthest vertex from the line defined by the first 2 vertices.
+        const btVector3 direction = (points[simplex[1]] - origin).normalized();
+        auto lineDistance = [&](const btVector3& value) -> btScalar {
+            const btVector3 delta = value - origin;
+            return (delta - direction.dot(delta) * direction).length2();
+        };
+        simplex[2] = maximize_element(points.begin(), points.end(), lineDistance) - points.begin();
+        if (btSqrt(lineDistance(points[simplex[2]])) <= epsilon) {
+            throw std::invalid_argument("Degenerate convex hull: all vertices are colinear.");
+        }
+
+        // 4th vertex: farthest vertex from the plane defined by the first 3 vertices.
+        const btVector3 normal = (points[simplex[1]] - origin).cross(points[simplex[2]] - origin).normalized();
+        simplex[3] = maximize_element(points.begin(), points.end(), [&](const btVector3& value) -> btScalar {
+            return btFabs(normal.dot(value - origin));
+        }) - points.begin();
+        btScalar planeDistance = normal.dot(points[simplex[3]] - origin);
+        if (btFabs(planeDistance) <= epsilon) {
+            throw std::invalid_argument("Degenerate convex hull: all vertices are coplanar.");
+        }
+        if (planeDistance > 0) {
+            std::swap(simplex[1], simplex[2]);
+        }
+
+        static const std::array<std::array<unsigned,3>,4> FACES = {{
+            {0,1,2},
+            {0,3,1},
+            {0,2,3},
+            {1,3,2},
+        }};
+        std::vector<unsigned> simplexFaces;
+        for (const auto& face : FACES) {
+            simplexFaces.push_back(addFace(simplex[face[0]], simplex[face[1]], simplex[face[2]]));
+        }
+        for (unsigned faceIndex : simplexFaces) {
+            Face& face = faces[faceIndex];
+            for (unsigned edge = 0; edge < 3; edge++) {
+                unsigned from = face.vertices[edge];
+                unsigned to = face.vertices[(edge+1)%3];
+                for (unsigned otherIndex : simplexFaces) {
+                    const auto& other = faces[otherIndex].vertices;
+                    for (unsigned otherEdge = 0; otherEdge < 3; otherEdge++) {
+                        if (other[otherEdge] == to && other[(otherEdge+1)%3] == from) {
+                            face.neighbours[edge] = otherIndex;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (unsigned point = 0; point < points.size(); point++) {
+            if (std::find(simplex.begin(), simplex.end(), point) == simplex.end()) {
+                assignPoint(point, simplexFaces);
+            }
+        }
+        for (unsigned faceIndex : simplexFaces) {
+            pushPending(faceIndex);
+        }
     }
-    center /= firstVertices.size();
-    for (unsigned i = 0; i < 4; i++) {
-        triangles.insert(std::make_unique<MeshTriangle>(firstVertices[i], firstVertices[(i+1)%4], firstVertices[(i+2)%4], center));
+
+    /**
+     * Tests if the horizon edges form a single closed loop.
+     *
+     * @return False if a vertex is used twice, or if the edges form several loops.
+     */
+    bool isSimpleHorizon() {
+        bool result = true;
+        for (const HorizonEdge& edge : horizon) {
+            if (horizonNext[edge.from] != NONE) {
+                result = false;
+            }
+            horizonNext[edge.from] = edge.to;
+        }
+        if (result) {
+            unsigned start = horizon[0].from;
+            unsigned vertex = start;
+            for (std::size_t i = 1; result && i < horizon.size(); i++) {
+                vertex = horizonNext[vertex];
+                result = (vertex != NONE) && (vertex != start);
+            }
+            result = result && (horizonNext[vertex] == start);
+        }
+        for (const HorizonEdge& edge : horizon) {
+            horizonNext[edge.from] = NONE;
+        }
+        return result;
     }
 
-    for (auto& vertex: vertices) {
-        auto it = std::find_if(firstVertices.begin(), firstVertices.end(), [&vertex](const btVector3& value) -> bool {
-            return &value == &vertex;
-        });
-        if (it == firstVertices.end()) {
-            addVertex(vertex);
+    /**
+     * Merges a point into the hull.
+     *
+     * @param startFace A face visible from the new point.
+     * @param eye Index of the point to add.
+     * @return False if the point was skipped (see isSimpleHorizon()).
+     */
+    bool addPoint(unsigned startFace, unsigned eye) {
+        const btVector3& eyePoint = points[eye];
+        iteration++;
+        visibleFaces.clear();
+        horizon.clear();
+        newFaces.clear();
+
+        // visible faces & horizon (breadth first search from startFace). Visibility is tested without
+        // tolerance: keeping nearly coplanar faces would create concave edges on the horizon.
+        faces[startFace].visited = iteration;
+        visibleFaces.push_back(startFace);
+        for (unsigned i = 0; i < visibleFaces.size(); i++) {
+            const Face& current = faces[visibleFaces[i]];
+            for (unsigned edge = 0; edge < 3; edge++) {
+                unsigned neighbourIndex = current.neighbours[edge];
+                Face& neighbour = faces[neighbourIndex];
+                if (neighbour.visited != iteration) {
+                    if (neighbour.distance(eyePoint) > 0) {
+                        neighbour.visited = iteration;
+                        visibleFaces.push_back(neighbourIndex);
+                    } else {
+                        horizon.push_back({current.vertices[edge], current.vertices[(edge+1)%3], neighbourIndex});
+                    }
+                }
+            }
+        }
+
+        if (!isSimpleHorizon()) {
+            Face& face = faces[startFace];
+            const btVector3& a = points[face.vertices[0]];
+            const btVector3& b = points[face.vertices[1]];
+            const btVector3& c = points[face.vertices[2]];
+            skippedError = std::max(skippedError, triangleDistance(eyePoint, a, b, c));
+            face.conflicts.erase(std::find(face.conflicts.begin(), face.conflicts.end(), eye));
+            pushPending(startFace);
+            return false;
+        }
+
+        // cone of new faces from the horizon to the eye.
+        for (const HorizonEdge& edge : horizon) {
+            unsigned faceIndex = addFace(edge.from, edge.to, eye);
+            faces[faceIndex].neighbours[0] = edge.outsideFace;
+            Face& outside = faces[edge.outsideFace];
+            for (unsigned outsideEdge = 0; outsideEdge < 3; outsideEdge++) {
+                if (outside.vertices[outsideEdge] == edge.to && outside.vertices[(outsideEdge+1)%3] == edge.from) {
+                    outside.neighbours[outsideEdge] = faceIndex;
+                }
+            }
+            newFaceFrom[edge.from] = faceIndex;
+            newFaceTo[edge.to] = faceIndex;
+            newFaces.push_back(faceIndex);
+        }
+        for (unsigned faceIndex : newFaces) {
+            Face& face = faces[faceIndex];
+            face.neighbours[1] = newFaceFrom[face.vertices[1]];
+            face.neighbours[2] = newFaceTo[face.vertices[0]];
+        }
+
+        // the visible faces are removed: their points go to the new faces (or are inside the hull).
+        for (unsigned faceIndex : visibleFaces) {
+            Face& face = faces[faceIndex];
+            for (unsigned point : face.conflicts) {
+                if (point != eye) {
+                    assignPoint(point, newFaces);
+                }
+            }
+            face.conflicts.clear();
+            face.alive = false;
+            freeFaces.push_back(faceIndex);
+        }
+        for (unsigned faceIndex : newFaces) {
+            pushPending(faceIndex);
         }
+        return true;
     }
+};
+
+ConvexMesh::ConvexMesh(std::vector<btVector3>&& inputVertices) :
+    ConvexMesh(inputVertices, std::numeric_limits<std::size_t>::max())
+{
+
+}
+
+ConvexMesh::ConvexMesh(const std::vector<btVector3>& inputVertices, std::size_t maxVertices) {
+    Quickhull hull(inputVertices, maxVertices);
+    hull.getMesh(vertices, indices, normals);
+    error = hull.getError();
 }
 
 ConvexMesh::ConvexMesh(const std::vector<btVector3>& vertices) :
@@ -271,67 +597,107 @@ ConvexMesh::ConvexMesh(const std::vector<btVector3>& vertices) :
 
 }
 
+/** Corner of a triangle: a vertex seen from one of the triangles using it. */
+struct MeshCorner {
+    /** Index of the triangle. */
+    unsigned triangle;
+    /** Previous vertex in the triangle (CCW order). */
+    unsigned previous;
+    /** Next vertex in the triangle (CCW order). */
+    unsigned next;
+};
+
+/**
+ * Sorts the corners around a vertex, so that consecutive triangles share an edge.
+ *
+ * This must be the full set of corners of this vertex: the triangles form a closed fan.
+ *
+ * @param[in,out] corners Corners of the triangles containing the same vertex.
+ */
+static void sortCornerFan(std::vector<MeshCorner>& corners) {
+    for (unsigned i = 1; i < corners.size(); i++) {
+        unsigned expected = corners[i-1].next;
+        auto it = std::find_if(corners.begin() + i, corners.end(), [expected](const MeshCorner& corner) -> bool {
+            return corner.previous == expected;
+        });
+        if (it != corners.end()) {
+            std::swap(corners[i], *it);
+        }
+    }
+}
+
 void ConvexMesh::addMargin(btScalar margin) {
     if (margin < 0) {
         throw std::invalid_argument("Can't add a negative margin");
     }
-    std::unordered_map<const btVector3*, std::unordered_set<const MeshTriangle*>> vertexToTriangles;
-    for (const auto& face : triangles) {
-        for (const btVector3& vertex : face->getVertices()) {
-            auto it = vertexToTriangles.emplace(std::piecewise_construct, std::forward_as_tuple(&vertex), std::forward_as_tuple());
-            it.first->second.emplace(face.get());
+    // corners of each vertex, stored contiguously: vertex v owns [firstCorner[v], firstCorner[v+1]).
+    std::vector<unsigned> firstCorner(vertices.size() + 1, 0);
+    for (unsigned vertex : indices) {
+        firstCorner[vertex+1]++;
+    }
+    for (unsigned vertex = 0; vertex < vertices.size(); vertex++) {
+        firstCorner[vertex+1] += firstCorner[vertex];
+    }
+    std::vector<MeshCorner> corners(indices.size());
+    std::vector<unsigned> cornerCount(vertices.size(), 0);
+    for (unsigned triangle = 0; triangle < getTriangleCount(); triangle++) {
+        for (unsigned k = 0; k < 3; k++) {
+            unsigned vertex = indices[3*triangle + k];
+            MeshCorner& corner = corners[firstCorner[vertex] + cornerCount[vertex]];
+            cornerCount[vertex]++;
+            corner.triangle = triangle;
+            corner.previous = indices[3*triangle + (k+2)%3];
+            corner.next = indices[3*triangle + (k+1)%3];
         }
     }
+
+    const btScalar minCos = btCos(btScalar(SIMD_PI/7));
     std::vector<btVector3> newConvexHull;
     newConvexHull.reserve(vertices.size());
-    for (auto& pair : vertexToTriangles) {
-        std::vector<const MeshTriangle*> circularList = sortFacesCW(*pair.first, pair.second);
-        std::vector<std::unordered_set<const MeshTriangle*>> partitions = partitionFacesByAngle(circularList, btScalar(SIMD_PI/7));
-        // extrude 1 vertex per partition.
-        for (const auto& partition : partitions) {
-            // direction = sum of the normals of each face in the partition, weighted
-            // by the angle of the 2 edges of this face. The goal is to extrude independently of
-            // how polygons were decomposed into triangles.
-            btVector3 extrudeDirection(0,0,0);
-            btScalar weightSum = 0;
-            for (auto face : partition) {
-                btScalar angle = angleInTriangle(*face, pair.first);
-                extrudeDirection+= angle * face->getNormal();
-                weightSum+= angle;
+    std::vector<MeshCorner> fan;
+    std::vector<unsigned> partitionStarts;
+    for (unsigned vertex = 0; vertex < vertices.size(); vertex++) {
+        const btVector3& position = vertices[vertex];
+        fan.assign(corners.begin() + firstCorner[vertex], corners.begin() + firstCorner[vertex+1]);
+        sortCornerFan(fan);
+        auto shouldMerge = [&](const MeshCorner& a, const MeshCorner& b) -> bool {
+            return normals[a.triangle].dot(normals[b.triangle]) > minCos;
+        };
+        // Partition the fan: two adjacent faces are in the same partition if the angle between
+        // their normals is small. The fan is circular: the last partition can join the first one.
+        partitionStarts.clear();
+        partitionStarts.push_back(0);
+        for (unsigned i = 1; i < fan.size(); i++) {
+            if (!shouldMerge(fan[i-1], fan[i])) {
+                partitionStarts.push_back(i);
             }
-            extrudeDirection = extrudeDirection / weightSum;
-            extrudeDirection.normalize();
-            newConvexHull.push_back(*pair.first + margin*extrudeDirection);
         }
-    }
-    *this = std::move(ConvexMesh(std::move(newConvexHull)));
-}
-
-void ConvexMesh::addVertex(const btVector3& vertex) {
-    std::unordered_set<MeshEdge,MeshEdge::Hash> horizon;
-    for (auto it = triangles.begin(); it != triangles.end(); /*empty*/) {
-        const MeshTriangle& triangle = **it;
-        if (triangle.offsetOff(vertex) > 0) {
-            const auto& vertices = triangle.getVertices();
-            std::array<MeshEdge,3> edges = {{
-                {vertices[0], vertices[1]},
-                {vertices[0], vertices[2]},
-                {vertices[1], vertices[2]},
-            }};
-            for (const MeshEdge& edge : edges) {
-                auto it = horizon.find(edge);
-                if (it == horizon.end()) {
-                    horizon.insert(edge);
-                } else {
-                    horizon.erase(it);
-                }
+        partitionStarts.push_back(fan.size());
+        bool mergeEnds = (partitionStarts.size() > 3) && shouldMerge(fan[0], fan[fan.size()-1]);
+        // direction = sum of the normals of each face in the partition, weighted
+        // by the angle of the 2 edges of this face. The goal is to extrude independently of
+        // how polygons were decomposed into triangles.
+        btVector3 extrudeDirection(0,0,0);
+        auto accumulate = [&](unsigned begin, unsigned end) {
+            for (unsigned i = begin; i < end; i++) {
+                const MeshCorner& corner = fan[i];
+                btScalar angle = btAngle(vertices[corner.next] - position, vertices[corner.previous] - position);
+                extrudeDirection += angle * normals[corner.triangle];
             }
-            it = triangles.erase(it);
-        } else {
-            it++;
+        };
+        unsigned lastPartition = partitionStarts.size() - 1;
+        if (mergeEnds) {
+            lastPartition--;
+        }
+        // extrude 1 vertex per partition.
+        for (unsigned partition = 0; partition < lastPartition; partition++) {
+            extrudeDirection.setZero();
+            accumulate(partitionStarts[partition], partitionStarts[partition+1]);
+            if (mergeEnds && partition == 0) {
+                accumulate(partitionStarts[lastPartition], fan.size());
+            }
+            newConvexHull.push_back(position + margin * extrudeDirection.normalized());
         }
     }
-    for (const MeshEdge& edge : horizon) {
-        triangles.insert(std::make_unique<MeshTriangle>(vertex, edge.first(), edge.second(), center));
-    }
-}
\ No newline at end of file
+    *this = ConvexMesh(std::move(newConvexHull));
+}
@@ -17,6 +17,7 @@
  */
 
 #include "CuboidShape.hpp"
+#include "ShapeCache.hpp"
 #include "lua/bindings/bullet.hpp"
 #include "lua/bindings/FundamentalTypes.hpp"
 #include "lua/types/LuaNativeString.hpp"
@@ -73,7 +74,7 @@ int CuboidShape::luaIndex(const std::string& memberName, LuaStateView& state) {
     return result;
 }
 
-std::unique_ptr<CuboidShape> CuboidShape::luaGetFromTable(LuaTable& table) {
+std::shared_ptr<CuboidShape> CuboidShape::luaGetFromTable(LuaTable& table) {
     auto halfExtents = table.get<LuaNativeString,Vector3<SI::Length>>("halfExtents");
     Scalar<SI::Mass> mass;
     if (table.has<LuaNativeString>("mass")) {
@@ -82,5 +83,17 @@ std::unique_ptr<CuboidShape> CuboidShape::luaGetFromTable(LuaTable& table) {
         auto density = table.get<LuaNativeString,Scalar<SI::Density>>("density");
         mass = density * cuboidVolume(halfExtents);
     }
-    return std::make_unique<CuboidShape>(mass, halfExtents);
+    return makeShared(mass, halfExtents);
+}
+
+std::shared_ptr<CuboidShape> CuboidShape::makeShared(Scalar<SI::Mass> mass, const Vector3<SI::Length>& halfExtents) {
+    ShapeCache::Key key("Cuboid");
+    key.add(toBulletUnits(mass)).add(toBulletUnits(halfExtents));
+    return ShapeCache::global().get<CuboidShape>(key, [&]() -> std::shared_ptr<CuboidShape> {
+        return std::make_shared<CuboidShape>(mass, halfExtents);
+    });
+}
+
+std::shared_ptr<CuboidShape> CuboidShape::makeShared(Scalar<SI::Density> density, const Vector3<SI::Length>& halfExtents) {
+    return makeShared(cuboidVolume(halfExtents) * density, halfExtents);
 }
@@ -20,6 +20,7 @@
 #include "lua/bindings/FundamentalTypes.hpp"
 #include "lua/types/LuaNativeString.hpp"
 #include "CylinderShape.hpp"
+#include "ShapeCache.hpp"
 #include "units/BulletUnits.hpp"
 
 CylinderShape::CylinderShape(Scalar<SI::Mass> mass, const Vector3<SI::Length>& halfExtents) :
@@ -73,7 +74,7 @@ int CylinderShape::luaIndex(const std::string& memberName, LuaStateView& state)
     return result;
 }
 
-std::unique_ptr<CylinderShape> CylinderShape::luaGetFromTable(LuaTable& table) {
+std::shared_ptr<CylinderShape> CylinderShape::luaGetFromTable(LuaTable& table) {
     auto halfExtents = table.get<LuaNativeString,Vector3<SI::Length>>("halfExtents");
     Scalar<SI::Mass> mass;
     if (table.has<LuaNativeString>("mass")) {
@@ -82,5 +83,17 @@ std::unique_ptr<CylinderShape> CylinderShape::luaGetFromTable(LuaTable& table) {
         auto density = table.get<LuaNativeString,Scalar<SI::Density>>("density");
         mass = density * cylinderVolume(halfExtents);
     }
-    return std::make_unique<CylinderShape>(mass, halfExtents);
+    return makeShared(mass, halfExtents);
+}
+
+std::shared_ptr<CylinderShape> CylinderShape::makeShared(Scalar<SI::Mass> mass, const Vector3<SI::Length>& halfExtents) {
+    ShapeCache::Key key("Cylinder");
+    key.add(toBulletUnits(mass)).add(toBulletUnits(halfExtents));
+    return ShapeCache::global().get<CylinderShape>(key, [&]() -> std::shared_ptr<CylinderShape> {
+        return std::make_shared<CylinderShape>(mass, halfExtents);
+    });
+}
+
+std::shared_ptr<CylinderShape> CylinderShape::makeShared(Scalar<SI::Density> density, const Vector3<SI::Length>& halfExtents) {
+    return makeShared(cylinderVolume(halfExtents) * density, halfExtents);
 }
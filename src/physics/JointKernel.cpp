@@ -0,0 +1,142 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#include "JointKernel.hpp"
+
+/**
+ * Computes the angular velocity change of a body per unit of angular impulse, in the joint frame.
+ *
+ * @param[in] body Body receiving the impulse.
+ * @param[in] jointBasis Orientation of the joint frame, relative to the inertial frame of the body.
+ * @param[in] axes Axes of the joint frame handled by the joint (1: handled, 0: ignored).
+ * @return The matrix converting an angular impulse into an angular velocity change (joint frame).
+ */
+static btMatrix3x3 computeGain(const btRigidBody& body, const btMatrix3x3& jointBasis, const btVector3& axes) {
+    btMatrix3x3 mask(axes.x(), 0, 0,
+                     0, axes.y(), 0,
+                     0, 0, axes.z());
+    return mask * jointBasis.transpose().scaled(body.getInvInertiaDiagLocal()) * jointBasis * mask;
+}
+
+JointKernel::Handle JointKernel::add(btRigidBody& convexBody, btRigidBody& concaveBody, const btMatrix3x3& jointBasis,
+                                     const btVector3& frictionCoefficients, const btVector3& axes)
+{
+    Handle result;
+    if (freeHandles.empty()) {
+        result = slots.size();
+        slots.push_back(handles.size());
+    } else {
+        result = freeHandles.back();
+        freeHandles.pop_back();
+        slots[result] = handles.size();
+    }
+    handles.push_back(result);
+    convexBodies.push_back(&convexBody);
+    concaveBodies.push_back(&concaveBody);
+    jointBases.push_back(jointBasis);
+    jointAxes.push_back(axes);
+    this->frictionCoefficients.push_back(frictionCoefficients * axes);
+    motorTorques.push_back(btVector3(0,0,0));
+    return result;
+}
+
+void JointKernel::remove(Handle handle) {
+    std::size_t slot = slots[handle];
+    handles.erase(handles.begin() + slot);
+    convexBodies.erase(convexBodies.begin() + slot);
+    concaveBodies.erase(concaveBodies.begin() + slot);
+    jointBases.erase(jointBases.begin() + slot);
+    jointAxes.erase(jointAxes.begin() + slot);
+    frictionCoefficients.erase(frictionCoefficients.begin() + slot);
+    motorTorques.erase(motorTorques.begin() + slot);
+    for (; slot < handles.size(); slot++) {
+        slots[handles[slot]] = slot;
+    }
+    freeHandles.push_back(handle);
+}
+
+/**
+ * Applies a permutation to an array.
+ *
+ * @param[in,out] values Array to reorder.
+ * @param[in] order New position -> old position.
+ */
+template<typename T>
+static void permute(std::vector<T>& values, const std::vector<std::size_t>& order) {
+    std::vector<T> result;
+    result.reserve(values.size());
+    for (std::size_t oldSlot : order) {
+        result.push_back(values[oldSlot]);
+    }
+    values = std::move(result);
+}
+
+void JointKernel::reorder(const std::vector<Handle>& order) {
+    assert(order.size() == size());
+    std::vector<std::size_t> oldSlots;
+    oldSlots.reserve(order.size());
+    for (Handle handle : order) {
+        oldSlots.push_back(slots[handle]);
+    }
+    permute(convexBodies, oldSlots);
+    permute(concaveBodies, oldSlots);
+    permute(jointBases, oldSlots);
+    permute(jointAxes, oldSlots);
+    permute(frictionCoefficients, oldSlots);
+    permute(motorTorques, oldSlots);
+    handles = order;
+    for (std::size_t slot = 0; slot < handles.size(); slot++) {
+        slots[handles[slot]] = slot;
+    }
+}
+
+void JointKernel::run(std::size_t begin, std::size_t end, btScalar timeStep) {
+    for (std::size_t slot = begin; slot < end; slot++) {
+        btRigidBody& convexBody = *convexBodies[slot];
+        btRigidBody& concaveBody = *concaveBodies[slot];
+        // Joint frame -> absolute frame.
+        btMatrix3x3 basis = convexBody.getWorldTransform().getBasis() * jointBases[slot];
+        // Friction
+        btVector3 relativeVelocity = concaveBody.getAngularVelocity() - convexBody.getAngularVelocity();
+        btVector3 refVelocity = relativeVelocity * basis;
+        btVector3 refFriction = refVelocity * frictionCoefficients[slot] * timeStep;
+        // Same joint frame for both bodies: the friction is computed relative to the convex part.
+        btVector3 convexImpulse = computeGain(convexBody, jointBases[slot], jointAxes[slot]) * refFriction;
+        btVector3 concaveImpulse = computeGain(concaveBody, jointBases[slot], jointAxes[slot]) * -refFriction;
+        btVector3 newRefVelocity = refVelocity + concaveImpulse - convexImpulse;
+        for (int i = 0; i < 3; i++) {
+            btScalar prevVel = refVelocity[i];
+            btScalar newVel = newRefVelocity[i];
+            if (newVel * prevVel < 0) {
+                btScalar factor = std::fabs(prevVel / (prevVel - newVel));
+                convexImpulse[i] *= factor;
+                concaveImpulse[i] *= factor;
+            }
+        }
+        convexBody.setAngularVelocity(convexBody.getAngularVelocity() + basis * convexImpulse);
+        concaveBody.setAngularVelocity(concaveBody.getAngularVelocity() + basis * concaveImpulse);
+        // Motor
+        btVector3 absMotorTorque = basis * motorTorques[slot];
+        convexBody.applyTorque(absMotorTorque);
+        concaveBody.applyTorque(-absMotorTorque);
+    }
+}
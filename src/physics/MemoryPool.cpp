@@ -0,0 +1,59 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryPool.hpp"
+
+MemoryPool& MemoryPool::global() {
+    static MemoryPool* result = new MemoryPool();
+    return *result;
+}
+
+void* MemoryPool::allocate(std::size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = freeBlocks.find(size);
+        if (it != freeBlocks.end() && !it->second.empty()) {
+            void* result = it->second.back();
+            it->second.pop_back();
+            return result;
+        }
+    }
+    return ::operator new(size, std::align_val_t(ALIGNMENT));
+}
+
+void MemoryPool::deallocate(void* block, std::size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    freeBlocks[size].push_back(block);
+}
+
+std::size_t MemoryPool::getFreeCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t result = 0;
+    for (const auto& pair : freeBlocks) {
+        result+= pair.second.size();
+    }
+    return result;
+}
+
+MemoryPool::~MemoryPool() {
+    for (auto& pair : freeBlocks) {
+        for (void* block : pair.second) {
+            ::operator delete(block, std::align_val_t(ALIGNMENT));
+        }
+    }
+}
@@ -20,6 +20,7 @@
 #include "lua/bindings/FundamentalTypes.hpp"
 
 #include "Shape.hpp"
+#include "CapsuleShape.hpp"
 #include "CompoundShape.hpp"
 #include "ConvexHullShape.hpp"
 #include "CuboidShape.hpp"
@@ -60,10 +61,12 @@ int Shape::luaIndex(const std::string& memberName, LuaStateView& state) {
     return result;
 }
 
-std::unique_ptr<Shape> Shape::luaGetFromTable(LuaTable& table) {
+std::shared_ptr<Shape> Shape::luaGetFromTable(LuaTable& table) {
     std::string type = table.get<LuaNativeString, LuaNativeString>("type");
     LuaTable params = table.get<LuaNativeString, LuaTable>("params");
-    if (type=="Compound") {
+    if (type=="Capsule") {
+        return CapsuleShape::luaGetFromTable(params);
+    } else if (type=="Compound") {
         return CompoundShape::luaGetFromTable(params);
     } else if (type=="ConvexHull") {
         return ConvexHullShape::luaGetFromTable(params);
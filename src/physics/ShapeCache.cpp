@@ -0,0 +1,45 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "ShapeCache.hpp"
+
+ShapeCache& ShapeCache::global() {
+    // Never destroyed: shapes can be released by static destructors.
+    static ShapeCache* result = new ShapeCache();
+    return *result;
+}
+
+std::size_t ShapeCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::count_if(entries.begin(), entries.end(), [](const auto& pair) -> bool {
+        return !pair.second.expired();
+    });
+}
+
+void ShapeCache::purge() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.expired()) {
+            it = entries.erase(it);
+        } else {
+            it++;
+        }
+    }
+    purgeSize = std::max<std::size_t>(entries.size(), 16);
+}
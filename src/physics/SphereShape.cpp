@@ -19,6 +19,7 @@
 #include "lua/bindings/bullet.hpp"
 #include "lua/types/LuaNativeString.hpp"
 #include "lua/types/LuaTable.hpp"
+#include "ShapeCache.hpp"
 #include "SphereShape.hpp"
 #include "units/BulletUnits.hpp"
 
@@ -73,7 +74,7 @@ int SphereShape::luaIndex(const std::string& memberName, LuaStateView& state) {
     return result;
 }
 
-std::unique_ptr<SphereShape> SphereShape::luaGetFromTable(LuaTable& table) {
+std::shared_ptr<SphereShape> SphereShape::luaGetFromTable(LuaTable& table) {
     auto radius = table.get<LuaNativeString,Scalar<SI::Length>>("radius");
     Scalar<SI::Mass> mass;
     if (table.has<LuaNativeString>("mass")) {
@@ -82,5 +83,17 @@ std::unique_ptr<SphereShape> SphereShape::luaGetFromTable(LuaTable& table) {
         auto density = table.get<LuaNativeString,Scalar<SI::Density>>("density");
         mass = density * sphereVolume(radius);
     }
-    return std::make_unique<SphereShape>(mass, radius);
+    return makeShared(mass, radius);
+}
+
+std::shared_ptr<SphereShape> SphereShape::makeShared(Scalar<SI::Mass> mass, Scalar<SI::Length> radius) {
+    ShapeCache::Key key("Sphere");
+    key.add(toBulletUnits(mass)).add(toBulletUnits(radius));
+    return ShapeCache::global().get<SphereShape>(key, [&]() -> std::shared_ptr<SphereShape> {
+        return std::make_shared<SphereShape>(mass, radius);
+    });
+}
+
+std::shared_ptr<SphereShape> SphereShape::makeShared(Scalar<SI::Density> density, Scalar<SI::Length> radius) {
+    return makeShared(sphereVolume(radius) * density, radius);
 }
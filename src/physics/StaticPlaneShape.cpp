@@ -19,6 +19,7 @@
 #include "lua/bindings/bullet.hpp"
 #include "lua/bindings/FundamentalTypes.hpp"
 #include "lua/types/LuaNativeString.hpp"
+#include "ShapeCache.hpp"
 #include "StaticPlaneShape.hpp"
 #include "units/BulletUnits.hpp"
 
@@ -65,8 +66,16 @@ int StaticPlaneShape::luaIndex(const std::string& memberName, LuaStateView& stat
     return result;
 }
 
-std::unique_ptr<StaticPlaneShape> StaticPlaneShape::luaGetFromTable(LuaTable& table) {
+std::shared_ptr<StaticPlaneShape> StaticPlaneShape::luaGetFromTable(LuaTable& table) {
     auto normal = table.get<LuaNativeString,Vector3<SI::NoUnit>>("normal");
     auto offset = table.get<LuaNativeString,Scalar<SI::Length>>("offset");
-    return std::make_unique<StaticPlaneShape>(normal, offset);
+    return makeShared(normal, offset);
+}
+
+std::shared_ptr<StaticPlaneShape> StaticPlaneShape::makeShared(const Vector3<SI::NoUnit>& normal, Scalar<SI::Length> offset) {
+    ShapeCache::Key key("StaticPlane");
+    key.add(toBulletUnits(normal)).add(toBulletUnits(offset));
+    return ShapeCache::global().get<StaticPlaneShape>(key, [&]() -> std::shared_ptr<StaticPlaneShape> {
+        return std::make_shared<StaticPlaneShape>(normal, offset);
+    });
 }
@@ -0,0 +1,42 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TransformBuffer.hpp"
+
+TransformBuffer::TransformBuffer() :
+    writeIndex(0),
+    sharedIndex(1),
+    readIndex(2)
+{
+
+}
+
+bool TransformBuffer::publish() {
+    unsigned previous = sharedIndex.exchange(writeIndex | FRESH_FLAG, std::memory_order_acq_rel);
+    writeIndex = previous & INDEX_MASK;
+    return (previous & FRESH_FLAG) == 0;
+}
+
+const TransformBuffer::Snapshot* TransformBuffer::readNew() {
+    if ((sharedIndex.load(std::memory_order_relaxed) & FRESH_FLAG) == 0) {
+        return nullptr;
+    }
+    unsigned previous = sharedIndex.exchange(readIndex, std::memory_order_acq_rel);
+    readIndex = previous & INDEX_MASK;
+    return &buffers[readIndex];
+}
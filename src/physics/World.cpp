@@ -16,39 +16,422 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include "LinearMath/btSerializer.h"
+#include "LinearMath/btThreads.h"
+
 #include "World.hpp"
 
+#include "BinaryStream.hpp"
 #include "lua/bindings/bullet.hpp"
 #include "lua/bindings/FundamentalTypes.hpp"
 #include "lua/bindings/luaVirtualClass/shared_ptr.hpp"
+#include "lua/helpers/LuaCount.hpp"
 #include "lua/types/LuaFunction.hpp"
 #include "lua/types/LuaMethod.hpp"
+#include "lua/types/LuaNativeString.hpp"
 #include "lua/LuaStateView.hpp"
 #include "SphereShape.hpp"
 #include "StaticPlaneShape.hpp"
 
+namespace {
+    /** Header of a world snapshot (padded to keep the body records aligned). */
+    struct SnapshotHeader {
+        /** File type identifier. */
+        char magic[4];
+        /** Version of the snapshot format. */
+        std::uint32_t version;
+        /** Size of each body record (sizeof(btRigidBodyData)). */
+        std::uint32_t bodyRecordSize;
+        /** Number of body records. */
+        std::uint32_t bodyCount;
+        /** Number of constraint states. */
+        std::uint32_t constraintCount;
+        /** Reserved (0). */
+        std::uint32_t reserved;
+    };
+
+    /** File type identifier of world snapshots. */
+    constexpr char SNAPSHOT_MAGIC[4] = {'I','N','S','W'};
+    /** Current version of the snapshot format. */
+    constexpr std::uint32_t SNAPSHOT_VERSION = 3;
+
+    /** Union-find structure over integer identifiers. */
+    class DisjointSets {
+    public:
+        /**
+         * Creates a new set containing a single new element.
+         * @return The identifier of the new element.
+         */
+        std::size_t newSet() {
+            std::size_t result = parents.size();
+            parents.push_back(result);
+            return result;
+        }
+
+        /**
+         * Gets the representative element of the set containing an element.
+         * @param[in] element Identifier of the element.
+         * @return The identifier of the representative element of its set.
+         */
+        std::size_t find(std::size_t element) {
+            while (parents[element] != element) {
+                parents[element] = parents[parents[element]];
+                element = parents[element];
+            }
+            return element;
+        }
+
+        /**
+         * Merges the sets containing two elements.
+         * @param[in] a First element.
+         * @param[in] b Second element.
+         */
+        void merge(std::size_t a, std::size_t b) {
+            std::size_t rootA = find(a);
+            std::size_t rootB = find(b);
+            if (rootA != rootB) {
+                // Smallest root wins: the result does not depend on the merge order.
+                parents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+            }
+        }
+    private:
+        /** Parent of each element (roots are their own parent). */
+        std::vector<std::size_t> parents;
+    };
+
+    /**
+     * Owner of Bullet's global task scheduler.
+     *
+     * The scheduler is shared by all the multithreaded worlds of the process: it
+     * runs with the highest number of threads requested so far. Bullet only keeps
+     * a raw pointer to it, so it is unregistered before being destroyed.
+     */
+    class TaskScheduler {
+    public:
+        /**
+         * Gets the unique instance of this class.
+         *
+         * @return The owner of Bullet's task scheduler.
+         */
+        static TaskScheduler& getInstance() {
+            static TaskScheduler instance;
+            return instance;
+        }
+
+        ~TaskScheduler() {
+#if BT_THREADSAFE
+            if (scheduler != nullptr) {
+                btSetTaskScheduler(btGetSequentialTaskScheduler());
+            }
+#endif
+        }
+
+        /**
+         * Gets the mutex guarding the task scheduler.
+         *
+         * The scheduler is not reentrant: multithreaded worlds are stepped one at a time,
+         * even when their scenes are stepped in parallel (see SceneGroup::step()).
+         *
+         * @return The mutex of the task scheduler.
+         */
+        std::mutex& getMutex() {
+            return mutex;
+        }
+
+        /**
+         * Prepares the task scheduler for a multithreaded world.
+         *
+         * @param[in] threads Number of threads requested by the world.
+         */
+        void init(unsigned threads) {
+#if BT_THREADSAFE
+            std::lock_guard<std::mutex> lock(mutex);
+            if (scheduler == nullptr) {
+                // Bullet's default scheduler: thread pool with work-stealing job queues.
+                scheduler.reset(btCreateDefaultTaskScheduler());
+                if (scheduler == nullptr) {
+                    throw std::runtime_error("World: unable to create Bullet's task scheduler.");
+                }
+                scheduler->setNumThreadsActive(1);
+                btSetTaskScheduler(scheduler.get());
+            }
+            int nbThreads = std::min<int>(threads, scheduler->getMaxNumThreads());
+            if (nbThreads > scheduler->getNumThreadsActive()) {
+                scheduler->setNumThreadsActive(nbThreads);
+            }
+#else
+            throw std::runtime_error("World: multithreaded worlds require Bullet built with BT_THREADSAFE (see INSIGHT_BULLET_THREADSAFE).");
+#endif
+        }
+    private:
+        TaskScheduler() = default;
+
+        /** Mutex guarding the scheduler (see getMutex()). */
+        std::mutex mutex;
+#if BT_THREADSAFE
+        /** Bullet's task scheduler (null until a multithreaded world is created). */
+        std::unique_ptr<btITaskScheduler> scheduler;
+#endif
+    };
+
+    /**
+     * Creates the broadphase of a world.
+     *
+     * @param[in] settings Construction parameters of the world.
+     * @return The new broadphase.
+     */
+    std::unique_ptr<btBroadphaseInterface> makeBroadphase(const World::Settings& settings) {
+        using Broadphase = World::Settings::Broadphase;
+        if (settings.broadphase == Broadphase::AxisSweep) {
+            btVector3 worldMin = toBulletUnits(settings.worldMin);
+            btVector3 worldMax = toBulletUnits(settings.worldMax);
+            if (worldMin.x() >= worldMax.x() || worldMin.y() >= worldMax.y() || worldMin.z() >= worldMax.z()) {
+                throw std::invalid_argument("World: the world bounds must have a positive size on each axis.");
+            }
+            if (settings.maxBodies == 0 || settings.maxBodies >= std::numeric_limits<unsigned>::max()) {
+                throw std::invalid_argument("World: invalid maximum number of bodies.");
+            }
+            // Handle 0 is reserved by Bullet.
+            return std::make_unique<bt32BitAxisSweep3>(worldMin, worldMax, settings.maxBodies + 1);
+        }
+        return std::make_unique<btDbvtBroadphase>();
+    }
+
+    /**
+     * Creates the collision configuration of a world.
+     *
+     * @param[in] settings Construction parameters of the world.
+     * @return The new collision configuration.
+     */
+    std::unique_ptr<btDefaultCollisionConfiguration> makeCollisionConfig(const World::Settings& settings) {
+        btDefaultCollisionConstructionInfo info;
+        info.m_defaultMaxPersistentManifoldPoolSize = settings.manifoldPoolSize;
+        info.m_defaultMaxCollisionAlgorithmPoolSize = settings.algorithmPoolSize;
+        return std::make_unique<btDefaultCollisionConfiguration>(info);
+    }
+
+    /**
+     * Creates the narrow phase dispatcher of a world.
+     *
+     * @param[in] settings Construction parameters of the world.
+     * @param config Collision configuration of the world.
+     * @return The new dispatcher.
+     */
+    std::unique_ptr<btDispatcher> makeDispatcher(const World::Settings& settings, btCollisionConfiguration* config) {
+        if (settings.threads == 0) {
+            throw std::invalid_argument("World: the number of threads must be at least 1.");
+        }
+        if (settings.threads > 1) {
+            TaskScheduler::getInstance().init(settings.threads);
+            return std::make_unique<btCollisionDispatcherMt>(config);
+        }
+        return std::make_unique<btCollisionDispatcher>(config);
+    }
+
+    /**
+     * Creates the constraint solver of a world.
+     *
+     * @param[in] settings Construction parameters of the world.
+     * @return The new solver.
+     */
+    std::unique_ptr<btConstraintSolver> makeSolver(const World::Settings& settings) {
+        if (settings.threads > 1) {
+            return std::make_unique<btConstraintSolverPoolMt>(settings.threads);
+        }
+        return std::make_unique<btSequentialImpulseConstraintSolver>();
+    }
+
+    /**
+     * Creates the Bullet world.
+     *
+     * @param[in] settings Construction parameters of the world.
+     * @param dispatcher Narrow phase dispatcher.
+     * @param broadPhase Broad phase algorithm.
+     * @param solver Constraint solver (created by makeSolver()).
+     * @param config Collision configuration.
+     * @return The new Bullet world.
+     */
+    std::unique_ptr<btDiscreteDynamicsWorld> makeWorld(const World::Settings& settings, btDispatcher* dispatcher,
+                                                       btBroadphaseInterface* broadPhase, btConstraintSolver* solver,
+                                                       btCollisionConfiguration* config)
+    {
+        if (settings.threads > 1) {
+            auto solverPool = static_cast<btConstraintSolverPoolMt*>(solver);
+            return std::make_unique<btDiscreteDynamicsWorldMt>(dispatcher, broadPhase, solverPool, nullptr, config);
+        }
+        return std::make_unique<btDiscreteDynamicsWorld>(dispatcher, broadPhase, solver, config);
+    }
+}
+
+/** Bullet parallel task running the constraints of each group (callbacks, then joint kernel). */
+class World::ConstraintGroupsTask : public btIParallelForBody {
+public:
+    /**
+     * Creates a new task.
+     *
+     * @param world World containing the constraints (one group per index of the parallel loop).
+     * @param timeStep Duration of the next integration step.
+     */
+    ConstraintGroupsTask(World& world, Scalar<BulletUnits::Time> timeStep) :
+        world(world),
+        timeStep(timeStep)
+    {
+
+    }
+
+    void forLoop(int iBegin, int iEnd) const override {
+        for (int index = iBegin; index < iEnd; index++) {
+            const ConstraintGroup& group = world.constraintGroups[index];
+            for (Constraint* constraint : group.callbacks) {
+                constraint->beforeTick(world, timeStep);
+            }
+            world.jointKernel.run(group.kernelBegin, group.kernelEnd, timeStep.value);
+        }
+    }
+private:
+    /** World containing the constraints. */
+    World& world;
+    /** Duration of the next integration step. */
+    Scalar<BulletUnits::Time> timeStep;
+};
+
+/** Broadphase filter: collision groups & masks, then the collision exceptions of the bodies. */
+class World::CollisionFilter : public btOverlapFilterCallback {
+public:
+    bool needBroadphaseCollision(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1) const override {
+        bool result = (proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) != 0;
+        result = result && (proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask) != 0;
+        if (result) {
+            // Bullet 2.88 ignores btCollisionObject::setIgnoreCollisionCheck() for rigid bodies.
+            auto body0 = static_cast<const Body*>(static_cast<btCollisionObject*>(proxy0->m_clientObject)->getUserPointer());
+            auto body1 = static_cast<const Body*>(static_cast<btCollisionObject*>(proxy1->m_clientObject)->getUserPointer());
+            result = body0 == nullptr || body1 == nullptr || body0->canCollideWith(*body1);
+        }
+        return result;
+    }
+};
+
 void World::beforeTickCallback(btDynamicsWorld* world, btScalar timeStep) {
     World* container = static_cast<World*>(world->getWorldUserInfo());
     container->beforeTick(Scalar<BulletUnits::Time>(timeStep));
 }
 
 World::World() :
-    broadPhase(std::make_unique<btDbvtBroadphase>()),
-    collisionConfig(std::make_unique<btDefaultCollisionConfiguration>()),
-    dispatcher(std::make_unique<btCollisionDispatcher>(collisionConfig.get())),
-    solver(std::make_unique<btSequentialImpulseConstraintSolver>()),
-    world(std::make_unique<btDiscreteDynamicsWorld>(dispatcher.get(), broadPhase.get(), solver.get(), collisionConfig.get())),
-    worldUpdater(*world)
+    World(Settings())
+{
+
+}
+
+World::World(const Settings& settings) :
+    settings(settings),
+    collisionFilter(std::make_unique<CollisionFilter>()),
+    broadPhase(makeBroadphase(settings)),
+    collisionConfig(makeCollisionConfig(settings)),
+    dispatcher(makeDispatcher(settings, collisionConfig.get())),
+    solver(makeSolver(settings)),
+    world(makeWorld(settings, dispatcher.get(), broadPhase.get(), solver.get(), collisionConfig.get())),
+    worldUpdater(*world),
+    constraintGroupsValid(true),
+    bodyEventsEnabled(false),
+    constraintsTime(0),
+    publishTime(0),
+    lostTime(0),
+    clampedSteps(0)
 {
     static const Vector3<SI::Acceleration> DEFAULT_GRAVITY(0, -9.8, 0);
     world->setGravity(toBulletUnits(DEFAULT_GRAVITY));
+    setFixedTimeStep(settings.fixedTimeStep);
+    setMaxSubSteps(settings.maxSubSteps);
+    setSolverIterations(settings.solverIterations);
+    world->getSolverInfo().m_splitImpulse = settings.splitImpulse;
+    broadPhase->getOverlappingPairCache()->setOverlapFilterCallback(collisionFilter.get());
     world->setInternalTickCallback(beforeTickCallback, static_cast<void*>(this), true);
 }
 
 void World::beforeTick(Scalar<BulletUnits::Time> timeStep) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    if (!constraintGroupsValid) {
+        updateConstraintGroups();
+    }
+    // Groups act on disjoint sets of bodies: they can run concurrently, and the result
+    // does not depend on the number of threads (a group is always run in the same order).
+    ConstraintGroupsTask task(*this, timeStep);
+    int nbGroups = static_cast<int>(constraintGroups.size());
+    if (settings.threads > 1) {
+        btParallelFor(0, nbGroups, 1, task);
+    } else {
+        // Bullet's task scheduler is global: single-threaded worlds may be stepped concurrently (SceneGroup::step()).
+        task.forLoop(0, nbGroups);
+    }
+    constraintsTime+= clock::now() - start;
+}
+
+void World::updateConstraintGroups() {
+    std::unordered_map<const btCollisionObject*, std::size_t> bodyIds;
+    DisjointSets sets;
+    auto getSet = [&bodyIds, &sets](const btRigidBody& body) -> std::size_t {
+        auto it = bodyIds.find(&body);
+        if (it == bodyIds.end()) {
+            it = bodyIds.emplace(&body, sets.newSet()).first;
+        }
+        return it->second;
+    };
+    // Every body touched by a constraint links its group, static & kinematic ones included:
+    // the callbacks & the joint kernel write the torques of both bodies (even if they
+    // have no effect on a static body), so two robots attached to the same anchor
+    // must not run concurrently.
+    std::vector<std::size_t> constraintSets;
+    constraintSets.reserve(constraints.size());
     for (auto& constraint : constraints) {
-        constraint->beforeTick(*this, timeStep);
+        btTypedConstraint& btConstraint = constraint->getConstraint();
+        std::size_t setId = getSet(btConstraint.getRigidBodyA());
+        sets.merge(setId, getSet(btConstraint.getRigidBodyB()));
+        constraintSets.push_back(setId);
     }
+
+    constraintGroups.clear();
+    std::unordered_map<std::size_t, std::size_t> groupIds;
+    std::vector<std::vector<JointKernel::Handle>> groupJoints;
+    for (std::size_t index = 0; index < constraints.size(); index++) {
+        std::size_t root = sets.find(constraintSets[index]);
+        auto it = groupIds.find(root);
+        if (it == groupIds.end()) {
+            it = groupIds.emplace(root, constraintGroups.size()).first;
+            constraintGroups.emplace_back();
+            groupJoints.emplace_back();
+        }
+        if (kernelHandles[index]) {
+            groupJoints[it->second].push_back(*kernelHandles[index]);
+        } else {
+            constraintGroups[it->second].callbacks.push_back(constraints[index].get());
+        }
+    }
+    // Joints of a group are stored in a contiguous range of the kernel.
+    std::vector<JointKernel::Handle> kernelOrder;
+    kernelOrder.reserve(jointKernel.size());
+    for (std::size_t groupId = 0; groupId < constraintGroups.size(); groupId++) {
+        ConstraintGroup& group = constraintGroups[groupId];
+        group.kernelBegin = kernelOrder.size();
+        kernelOrder.insert(kernelOrder.end(), groupJoints[groupId].begin(), groupJoints[groupId].end());
+        group.kernelEnd = kernelOrder.size();
+    }
+    jointKernel.reorder(kernelOrder);
+    constraintGroupsValid = true;
 }
 
 Vector3<SI::Acceleration> World::getGravity() const {
@@ -66,10 +449,17 @@ void World::setGravity(const Vector3<SI::Acceleration>& value) {
 }
 
 void World::addObject(std::shared_ptr<Body> object) {
+    if (settings.broadphase == Settings::Broadphase::AxisSweep && objects.size() >= settings.maxBodies) {
+        throw std::length_error("World: the broadphase is full (see World::Settings::maxBodies).");
+    }
     Body& body = *object.get();
-    world->addRigidBody(&body.getBulletBody());
+    world->addRigidBody(&body.getBulletBody(), body.getCollisionGroup(), body.getCollisionMask());
     object->setWorldUpdater(&worldUpdater);
-    objects.insert(std::move(object));
+    worldUpdater.onBodyMove(body);
+    objects.push_back(std::move(object));
+    if (bodyEventsEnabled) {
+        newBodyEvents.emplace_back(body, body.getSharedShape());
+    }
     for (auto listener : createListener) {
         listener->onBodyCreation(body);
     }
@@ -77,7 +467,76 @@ void World::addObject(std::shared_ptr<Body> object) {
 
 void World::addConstraint(std::shared_ptr<Constraint> constraint) {
     world->addConstraint(&constraint->getConstraint());
-    constraints.insert(std::move(constraint));
+    kernelHandles.push_back(constraint->addToKernel(jointKernel));
+    constraints.push_back(std::move(constraint));
+    constraintGroupsValid = false;
+}
+
+void World::removeObject(Body& object) {
+    auto it = std::find_if(objects.begin(), objects.end(), [&object](const std::shared_ptr<Body>& value) {
+        return value.get() == &object;
+    });
+    if (it == objects.end()) {
+        throw std::invalid_argument("World: cannot remove a body that is not in this world.");
+    }
+    btRigidBody& btBody = object.getBulletBody();
+    for (std::size_t index = constraints.size(); index > 0; index--) {
+        btTypedConstraint& btConstraint = constraints[index-1]->getConstraint();
+        if (&btConstraint.getRigidBodyA() == &btBody || &btConstraint.getRigidBodyB() == &btBody) {
+            removeConstraint(*constraints[index-1]);
+        }
+    }
+    // Keeps the body alive until the listeners are informed.
+    std::shared_ptr<Body> removed = std::move(*it);
+    objects.erase(it);
+    worldUpdater.removeBody(object);
+    unreadBodies.erase(std::remove(unreadBodies.begin(), unreadBodies.end(), &object), unreadBodies.end());
+    if (bodyEventsEnabled) {
+        // The last event at this address (if any) is about this body, not a previous one.
+        auto last = std::find_if(newBodyEvents.rbegin(), newBodyEvents.rend(), [&object](const TransformBuffer::BodyEvent& event) {
+            return event.body == &object;
+        });
+        if (last != newBodyEvents.rend() && last->shape != nullptr) {
+            // Added & removed between two snapshots: the consumer never knew this body.
+            newBodyEvents.erase(std::next(last).base());
+        } else {
+            newBodyEvents.emplace_back(object, nullptr);
+        }
+    }
+    world->removeRigidBody(&btBody);
+    object.setWorldUpdater(nullptr);
+    for (auto listener : createListener) {
+        listener->onBodyDeletion(object);
+    }
+}
+
+void World::removeConstraint(Constraint& constraint) {
+    auto it = std::find_if(constraints.begin(), constraints.end(), [&constraint](const std::shared_ptr<Constraint>& value) {
+        return value.get() == &constraint;
+    });
+    if (it == constraints.end()) {
+        throw std::invalid_argument("World: cannot remove a constraint that is not in this world.");
+    }
+    std::size_t index = it - constraints.begin();
+    world->removeConstraint(&constraint.getConstraint());
+    if (kernelHandles[index]) {
+        constraint.removeFromKernel(jointKernel);
+    }
+    kernelHandles.erase(kernelHandles.begin() + index);
+    constraints.erase(it);
+    constraintGroupsValid = false;
+}
+
+bool World::hasObject(const Body& object) const {
+    return std::any_of(objects.begin(), objects.end(), [&object](const std::shared_ptr<Body>& value) {
+        return value.get() == &object;
+    });
+}
+
+bool World::hasConstraint(const Constraint& constraint) const {
+    return std::any_of(constraints.begin(), constraints.end(), [&constraint](const std::shared_ptr<Constraint>& value) {
+        return value.get() == &constraint;
+    });
 }
 
 Scalar<SI::Length> World::getDefaultMargin() {
@@ -102,23 +561,274 @@ int World::luaIndex(const std::string& memberName, LuaStateView& state) {
             object.addObject(std::move(newBody));
             return 1;
         });
+    } else if (memberName=="removeBody") {
+        state.push<Method>([](World& object, LuaStateView& state) -> int {
+            std::shared_ptr<Body> body = state.get<std::shared_ptr<Body>>(2);
+            object.removeObject(*body);
+            return 0;
+        });
     } else if (memberName=="newShape") {
         state.push<LuaFunction>([](LuaStateView& state) -> int {
             std::shared_ptr<Shape> newShape = state.get<std::shared_ptr<Shape>>(1);
             state.push<std::shared_ptr<Shape>>(std::move(newShape));
             return 1;
         });
+    } else if (memberName=="fixedTimeStep") {
+        state.push<Scalar<SI::Time>>(settings.fixedTimeStep);
+    } else if (memberName=="setFixedTimeStep") {
+        state.push<Method>([](World& object, LuaStateView& state) -> int {
+            object.setFixedTimeStep(state.get<Scalar<SI::Time>>(2));
+            return 0;
+        });
+    } else if (memberName=="maxSubSteps") {
+        state.push<double>(settings.maxSubSteps);
+    } else if (memberName=="setMaxSubSteps") {
+        state.push<Method>([](World& object, LuaStateView& state) -> int {
+            double value = state.get<double>(2);
+            if (!isLuaCount<unsigned>(value, 1)) {
+                throw LuaException("World: 'maxSubSteps' must be an integer, at least 1.");
+            }
+            object.setMaxSubSteps(static_cast<unsigned>(value));
+            return 0;
+        });
+    } else if (memberName=="solverIterations") {
+        state.push<double>(settings.solverIterations);
+    } else if (memberName=="setSolverIterations") {
+        state.push<Method>([](World& object, LuaStateView& state) -> int {
+            double value = state.get<double>(2);
+            if (!isLuaCount<unsigned>(value, 1)) {
+                throw LuaException("World: 'solverIterations' must be an integer, at least 1.");
+            }
+            object.setSolverIterations(static_cast<unsigned>(value));
+            return 0;
+        });
+    } else if (memberName=="lostTime") {
+        state.push<Scalar<SI::Time>>(lostTime);
+    } else if (memberName=="clampedSteps") {
+        state.push<double>(clampedSteps);
     } else if (memberName=="defaultMargin") {
         state.push<Scalar<SI::Length>>(getDefaultMargin());
+    } else if (memberName=="saveSnapshot") {
+        state.push<Method>([](World& object, LuaStateView& state) -> int {
+            std::string path = state.get<LuaNativeString>(2);
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Cannot create snapshot file: " + path);
+            }
+            object.saveSnapshot(file);
+            return 0;
+        });
+    } else if (memberName=="loadSnapshot") {
+        state.push<Method>([](World& object, LuaStateView& state) -> int {
+            std::string path = state.get<LuaNativeString>(2);
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Cannot open snapshot file: " + path);
+            }
+            object.loadSnapshot(file);
+            return 0;
+        });
     } else {
         result = 0;
     }
     return result;
 }
 
+void World::setFixedTimeStep(Scalar<SI::Time> value) {
+    if (!(value.value > 0)) {
+        throw std::invalid_argument("World: the fixed time step must be positive.");
+    }
+    settings.fixedTimeStep = value;
+}
+
+void World::setMaxSubSteps(unsigned value) {
+    if (value == 0) {
+        throw std::invalid_argument("World: the maximum number of substeps must be at least 1.");
+    }
+    settings.maxSubSteps = value;
+}
+
+void World::setSolverIterations(unsigned value) {
+    if (value == 0) {
+        throw std::invalid_argument("World: the number of solver iterations must be at least 1.");
+    }
+    settings.solverIterations = value;
+    world->getSolverInfo().m_numIterations = value;
+}
+
 void World::stepSimulation(double timeStep) {
-    worldUpdater.newFrame();
-    world->stepSimulation(timeStep,4,btScalar(1/240.0));
+    std::unique_lock<std::mutex> schedulerLock;
+    if (settings.threads > 1) {
+        schedulerLock = std::unique_lock<std::mutex>(TaskScheduler::getInstance().getMutex());
+    }
+    constraintsTime = std::chrono::steady_clock::duration(0);
+    btScalar fixedTimeStep = toBulletUnits(settings.fixedTimeStep);
+    int maxSubSteps = settings.maxSubSteps;
+    // Bullet returns the number of substeps required, before clamping to maxSubSteps.
+    int requiredSteps = world->stepSimulation(timeStep, maxSubSteps, fixedTimeStep);
+    if (requiredSteps > maxSubSteps) {
+        lostTime += fromBulletValue<SI::Time>((requiredSteps - maxSubSteps) * fixedTimeStep);
+        clampedSteps++;
+    }
+    auto publishStart = std::chrono::steady_clock::now();
+    publishTransforms();
+    publishTime = std::chrono::steady_clock::now() - publishStart;
+}
+
+void World::publishTransforms() {
+    std::vector<Body*>& movedBodies = worldUpdater.getDirtyBodies();
+    std::sort(movedBodies.begin(), movedBodies.end());
+    movedBodies.erase(std::unique(movedBodies.begin(), movedBodies.end()), movedBodies.end());
+    std::vector<Body*> publishedBodies;
+    publishedBodies.reserve(unreadBodies.size() + movedBodies.size());
+    std::set_union(unreadBodies.begin(), unreadBodies.end(), movedBodies.begin(), movedBodies.end(),
+                   std::back_inserter(publishedBodies));
+    if (publishedBodies.empty() && unreadBodyEvents.empty() && newBodyEvents.empty()) {
+        return;
+    }
+    TransformBuffer::Snapshot& snapshot = transforms.getWriteBuffer();
+    snapshot.events.clear();
+    snapshot.events.reserve(unreadBodyEvents.size() + newBodyEvents.size());
+    snapshot.events.insert(snapshot.events.end(), unreadBodyEvents.begin(), unreadBodyEvents.end());
+    snapshot.events.insert(snapshot.events.end(), newBodyEvents.begin(), newBodyEvents.end());
+    snapshot.transforms.clear();
+    snapshot.transforms.reserve(publishedBodies.size());
+    for (Body* body : publishedBodies) {
+        snapshot.transforms.emplace_back(*body, body->getEngineTransform());
+    }
+    if (transforms.publish()) {
+        // The previous snapshot was read: the consumer only misses the changes since then.
+        unreadBodies.swap(movedBodies);
+        unreadBodyEvents.swap(newBodyEvents);
+    } else {
+        unreadBodies.swap(publishedBodies);
+        unreadBodyEvents.insert(unreadBodyEvents.end(), newBodyEvents.begin(), newBodyEvents.end());
+    }
+    movedBodies.clear();
+    newBodyEvents.clear();
+}
+
+const TransformBuffer::Snapshot* World::readTransforms() const {
+    return transforms.readNew();
+}
+
+void World::SnapshotData::write(std::ostream& stream) const {
+    SnapshotHeader header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.bodyRecordSize = sizeof(btRigidBodyData);
+    header.bodyCount = bodies.size();
+    header.constraintCount = constraints.size();
+    header.reserved = 0;
+    writeBinary(stream, header);
+    for (const auto& body : bodies) {
+        writeBinary(stream, body);
+    }
+    // Constraint states are prefixed by their size: they can be read without the constraints.
+    for (const auto& constraint : constraints) {
+        writeBinaryString(stream, constraint);
+    }
+}
+
+World::SnapshotData World::SnapshotData::read(std::istream& stream) {
+    auto header = readBinary<SnapshotHeader>(stream);
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("World: not a snapshot file.");
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        throw std::runtime_error("World: unsupported snapshot version.");
+    }
+    if (header.bodyRecordSize != sizeof(btRigidBodyData)) {
+        throw std::runtime_error("World: snapshot made with a different precision of Bullet.");
+    }
+    SnapshotData result;
+    for (std::uint32_t index = 0; index < header.bodyCount; index++) {
+        result.bodies.push_back(readBinary<btRigidBodyData>(stream));
+    }
+    for (std::uint32_t index = 0; index < header.constraintCount; index++) {
+        result.constraints.push_back(readBinaryString(stream));
+    }
+    return result;
+}
+
+World::SnapshotData World::makeSnapshot() const {
+    SnapshotData result;
+    result.bodies.reserve(objects.size());
+    btDefaultSerializer serializer;
+    for (auto& object : objects) {
+        btRigidBodyData data;
+        std::memset(&data, 0, sizeof(data));
+        object->saveState(data, serializer);
+        result.bodies.push_back(data);
+    }
+    result.constraints.reserve(constraints.size());
+    for (auto& constraint : constraints) {
+        std::ostringstream state;
+        constraint->saveState(state);
+        result.constraints.push_back(state.str());
+    }
+    return result;
+}
+
+void World::applySnapshot(const SnapshotData& snapshot) {
+    if (snapshot.bodies.size() != objects.size() || snapshot.constraints.size() != constraints.size()) {
+        throw std::runtime_error("World: the snapshot does not match the bodies & constraints of this world.");
+    }
+    SnapshotData previousState = makeSnapshot();
+    try {
+        loadSnapshotData(snapshot);
+    } catch (...) {
+        // A constraint rejected its state: the snapshot is applied entirely, or not at all.
+        loadSnapshotData(previousState);
+        throw;
+    }
+}
+
+void World::loadSnapshotData(const SnapshotData& snapshot) {
+    for (std::size_t index = 0; index < objects.size(); index++) {
+        objects[index]->loadState(snapshot.bodies[index]);
+    }
+    for (std::size_t index = 0; index < constraints.size(); index++) {
+        std::istringstream state(snapshot.constraints[index]);
+        constraints[index]->loadState(state);
+        if (state.peek() != std::istringstream::traits_type::eof()) {
+            throw std::runtime_error("World: the snapshot does not match the constraints of this world.");
+        }
+    }
+    // Contacts & warm starting data from the previous state are no longer valid.
+    auto pairCache = broadPhase->getOverlappingPairCache();
+    for (auto& object : objects) {
+        btRigidBody& btBody = object->getBulletBody();
+        world->updateSingleAabb(&btBody);
+        pairCache->cleanProxyFromPairs(btBody.getBroadphaseHandle(), dispatcher.get());
+    }
+    solver->reset();
+    publishTransforms();
+}
+
+void World::saveSnapshot(std::ostream& stream) const {
+    makeSnapshot().write(stream);
+    if (!stream) {
+        throw std::runtime_error("World: failed to write the snapshot.");
+    }
+}
+
+void World::loadSnapshot(std::istream& stream) {
+    applySnapshot(SnapshotData::read(stream));
+}
+
+World::TransformBatch::TransformBatch(World& world) :
+    world(world)
+{
+    world.worldUpdater.beginBatch();
+}
+
+World::TransformBatch::~TransformBatch() {
+    world.worldUpdater.endBatch();
+}
+
+void World::enableBodyEvents() const {
+    bodyEventsEnabled = true;
 }
 
 void World::addCreationListener(BodyCreationListener& listener) const {
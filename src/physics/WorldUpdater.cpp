@@ -16,30 +16,102 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
+#include "Body.hpp"
 #include "WorldUpdater.hpp"
 
+namespace {
+    /** Broadphase callback waking up every body it visits. */
+    class ActivationCallback : public btBroadphaseAabbCallback {
+    public:
+        bool process(const btBroadphaseProxy* proxy) override {
+            static_cast<btCollisionObject*>(proxy->m_clientObject)->activate();
+            return true;
+        }
+    };
+
+    /**
+     * Computes the box of a body at its current position.
+     * @param body Body whose box is computed.
+     * @param[out] aabbMin Minimum corner of the box.
+     * @param[out] aabbMax Maximum corner of the box.
+     */
+    void getAabb(const btRigidBody& body, btVector3& aabbMin, btVector3& aabbMax) {
+        body.getCollisionShape()->getAabb(body.getWorldTransform(), aabbMin, aabbMax);
+    }
+}
+
 WorldUpdater::WorldUpdater(btDiscreteDynamicsWorld& world) :
     world(world),
-    allReactivated(false)
+    batchDepth(0)
 {
 
 }
 
-void WorldUpdater::newFrame() {
-    allReactivated = false;
+void WorldUpdater::beginBatch() {
+    batchDepth++;
+}
+
+void WorldUpdater::endBatch() {
+    batchDepth--;
+    if (batchDepth == 0) {
+        flush();
+    }
 }
 
 void WorldUpdater::updateTransform(btRigidBody& body, const btTransform& newTransform) {
-    // Note: a clever & efficient way to update only the adjacent bodies would be nice.
-    if (!allReactivated) {
-        auto& objects = world.getCollisionObjectArray();
-        for (int index = 0; index < objects.size(); index++) {
-            objects[index]->activate();
-        }
-        allReactivated = true;
+    auto inserted = movedIndices.emplace(&body, movedBodies.size());
+    if (inserted.second) {
+        // Only the position before the batch is known by the broadphase.
+        MovedBody movedBody;
+        movedBody.body = &body;
+        getAabb(body, movedBody.oldAabbMin, movedBody.oldAabbMax);
+        movedBodies.push_back(movedBody);
     }
-    world.removeRigidBody(&body);
     body.setWorldTransform(newTransform);
     body.setInterpolationWorldTransform(newTransform);
-    world.addRigidBody(&body);
+    if (batchDepth == 0) {
+        flush();
+    }
+}
+
+void WorldUpdater::removeBody(Body& body) {
+    auto it = movedIndices.find(&body.getBulletBody());
+    if (it != movedIndices.end()) {
+        // The old box is kept: its neighbours are still woken up.
+        movedBodies[it->second].body = nullptr;
+        movedIndices.erase(it);
+    }
+    dirtyBodies.erase(std::remove(dirtyBodies.begin(), dirtyBodies.end(), &body), dirtyBodies.end());
+}
+
+void WorldUpdater::flush() {
+    if (movedBodies.empty()) {
+        return;
+    }
+    btBroadphaseInterface& broadphase = *world.getBroadphase();
+    for (const MovedBody& movedBody : movedBodies) {
+        btRigidBody* body = movedBody.body;
+        if (body != nullptr) {
+            world.updateSingleAabb(body);
+            // Contact points computed at the old position are no longer valid.
+            broadphase.getOverlappingPairCache()->cleanProxyFromPairs(body->getBroadphaseHandle(), world.getDispatcher());
+            body->activate(true);
+        }
+    }
+    // The old & new boxes of each body are tested separately: a body teleported far
+    // away doesn't wake up everything between its two positions.
+    ActivationCallback callback;
+    for (const MovedBody& movedBody : movedBodies) {
+        broadphase.aabbTest(movedBody.oldAabbMin, movedBody.oldAabbMax, callback);
+        if (movedBody.body != nullptr) {
+            btVector3 newAabbMin, newAabbMax;
+            getAabb(*movedBody.body, newAabbMin, newAabbMax);
+            broadphase.aabbTest(newAabbMin, newAabbMax, callback);
+        }
+    }
+
+    movedBodies.clear();
+    movedIndices.clear();
 }
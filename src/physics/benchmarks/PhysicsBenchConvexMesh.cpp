@@ -0,0 +1,78 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "btBulletDynamicsCommon.h"
+
+#include "ConvexMesh.hpp"
+
+/**
+ * Generates random points.
+ *
+ * @param count Number of points to generate.
+ * @param onSphere True to generate points on the unit sphere (all on the hull),
+ * false to generate points in the unit cube (few on the hull).
+ * @return The generated points.
+ */
+static std::vector<btVector3> randomPoints(std::size_t count, bool onSphere) {
+    std::mt19937 generator(count);
+    std::uniform_real_distribution<btScalar> distribution(-1, 1);
+    std::vector<btVector3> result;
+    result.reserve(count);
+    while (result.size() < count) {
+        btVector3 point(distribution(generator), distribution(generator), distribution(generator));
+        if (!onSphere) {
+            result.push_back(point);
+        } else if (point.length2() > btScalar(0.01)) {
+            result.push_back(point.normalized());
+        }
+    }
+    return result;
+}
+
+/**
+ * Measures the construction of a ConvexMesh, and prints the result on the standard output.
+ *
+ * @param name Name of the point distribution.
+ * @param points Input points of the hull.
+ * @param maxVertices Vertex budget of the hull.
+ */
+static void benchmark(const char* name, const std::vector<btVector3>& points, std::size_t maxVertices = std::numeric_limits<std::size_t>::max()) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    ConvexMesh mesh(points, maxVertices);
+    std::chrono::duration<double, std::milli> duration = Clock::now() - start;
+    std::cout << name << ": " << points.size() << " points -> " << mesh.getVertices().size() << " vertices, ";
+    std::cout << mesh.getTriangleCount() << " triangles (error: " << mesh.getError() << ") in " << duration.count() << " ms" << std::endl;
+}
+
+int main() {
+    for (std::size_t count : {10000, 100000, 1000000}) {
+        benchmark("cube", randomPoints(count, false));
+        std::vector<btVector3> sphere = randomPoints(count, true);
+        benchmark("sphere", sphere);
+        benchmark("sphere (256 vertices budget)", sphere, 256);
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Body.hpp"
+#include "CapsuleShape.hpp"
+#include "CuboidShape.hpp"
+#include "CylinderShape.hpp"
+#include "SphereShape.hpp"
+#include "StaticPlaneShape.hpp"
+#include "World.hpp"
+
+/** Duration of a simulation step (s). */
+static const double TICK_DURATION = 1.0/60;
+/** Number of simulated steps in each scene. */
+static const unsigned TICK_COUNT = 600;
+
+/**
+ * Adds a static ground (plane y=0) into a world.
+ * @param world World receiving the ground.
+ */
+static void addGround(World& world) {
+    auto shape = StaticPlaneShape::makeShared(Vector3<SI::NoUnit>(0, 1, 0), Scalar<SI::Length>(0));
+    world.addObject(std::make_shared<Body>(shape));
+}
+
+/**
+ * Adds a dynamic body into a world.
+ * @param world World receiving the body.
+ * @param shape Shape of the body.
+ * @param position Position of the body.
+ */
+static void addBody(World& world, std::shared_ptr<Shape> shape, const Vector3<SI::Length>& position) {
+    auto body = std::make_shared<Body>(std::move(shape));
+    body->setPosition(position);
+    world.addObject(std::move(body));
+}
+
+/**
+ * Scene with a dense pile of mixed shapes falling on the ground.
+ * @param world World receiving the scene.
+ */
+static void makePile(World& world) {
+    const Scalar<SI::Density> density(1000);
+    const std::vector<std::shared_ptr<Shape>> shapes = {
+        SphereShape::makeShared(density, Scalar<SI::Length>(0.25)),
+        CuboidShape::makeShared(density, Vector3<SI::Length>(0.2, 0.2, 0.2)),
+        CylinderShape::makeShared(density, Vector3<SI::Length>(0.2, 0.25, 0.2)),
+        CapsuleShape::makeShared(density, Scalar<SI::Length>(0.15), Scalar<SI::Length>(0.15)),
+    };
+    addGround(world);
+    std::size_t shapeId = 0;
+    for (int y = 0; y < 10; y++) {
+        for (int x = 0; x < 10; x++) {
+            for (int z = 0; z < 10; z++) {
+                // Odd layers are shifted, so that the bodies don't land straight on each other.
+                double shift = (y % 2) * 0.25;
+                Vector3<SI::Length> position(0.6*x + shift, 0.5 + 0.6*y, 0.6*z + shift);
+                addBody(world, shapes[shapeId % shapes.size()], position);
+                shapeId++;
+            }
+        }
+    }
+}
+
+/**
+ * Scene with many bodies spread on a large area (most of them fall asleep quickly).
+ * @param world World receiving the scene.
+ */
+static void makeSparse(World& world) {
+    auto shape = SphereShape::makeShared(Scalar<SI::Density>(1000), Scalar<SI::Length>(0.5));
+    addGround(world);
+    for (int x = 0; x < 50; x++) {
+        for (int z = 0; z < 50; z++) {
+            addBody(world, shape, Vector3<SI::Length>(8.0*x - 200, 0.5 + 0.1*((x+z) % 5), 8.0*z - 200));
+        }
+    }
+}
+
+/**
+ * Measures the step time of a scene, and prints the result on the standard output.
+ *
+ * @param sceneName Name of the scene.
+ * @param makeScene Function filling a world with the scene.
+ * @param configName Name of the world settings.
+ * @param settings Construction parameters of the world.
+ */
+static void benchmark(const char* sceneName, void (*makeScene)(World&), const char* configName, const World::Settings& settings) {
+    using Clock = std::chrono::steady_clock;
+    World world(settings);
+    makeScene(world);
+    Clock::time_point start = Clock::now();
+    for (unsigned tick = 0; tick < TICK_COUNT; tick++) {
+        world.stepSimulation(TICK_DURATION);
+    }
+    std::chrono::duration<double, std::milli> duration = Clock::now() - start;
+    std::cout << sceneName << ", " << std::left << std::setw(24) << configName << std::right << ": ";
+    std::cout << duration.count() / TICK_COUNT << " ms/step" << std::endl;
+}
+
+int main() {
+    using Broadphase = World::Settings::Broadphase;
+    std::vector<std::pair<const char*, World::Settings>> configs;
+
+    configs.emplace_back("default (dbvt)", World::Settings());
+
+    World::Settings axisSweep;
+    axisSweep.broadphase = Broadphase::AxisSweep;
+    axisSweep.worldMin = Vector3<SI::Length>(-250, -10, -250);
+    axisSweep.worldMax = Vector3<SI::Length>(250, 50, 250);
+    axisSweep.maxBodies = 4096;
+    configs.emplace_back("axisSweep", axisSweep);
+
+    World::Settings fastSolver;
+    fastSolver.solverIterations = 4;
+    configs.emplace_back("4 solver iterations", fastSolver);
+
+    World::Settings preciseSolver;
+    preciseSolver.solverIterations = 20;
+    configs.emplace_back("20 solver iterations", preciseSolver);
+
+    World::Settings noSplitImpulse;
+    noSplitImpulse.splitImpulse = false;
+    configs.emplace_back("no split impulse", noSplitImpulse);
+
+    World::Settings smallPools;
+    smallPools.manifoldPoolSize = 256;
+    smallPools.algorithmPoolSize = 256;
+    configs.emplace_back("pools of 256", smallPools);
+
+    World::Settings bigPools;
+    bigPools.manifoldPoolSize = 32768;
+    bigPools.algorithmPoolSize = 32768;
+    configs.emplace_back("pools of 32768", bigPools);
+
+    std::cout << TICK_COUNT << " steps of " << TICK_DURATION << " s per scene." << std::endl;
+    for (auto& config : configs) {
+        benchmark("pile (1000 bodies)", makePile, config.first, config.second);
+    }
+    for (auto& config : configs) {
+        benchmark("sparse (2500 bodies)", makeSparse, config.first, config.second);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BINARYSTREAM_HPP
+#define BINARYSTREAM_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/**
+ * Writes a value in its binary representation (native byte order).
+ *
+ * @param stream Output stream.
+ * @param[in] value Value to write.
+ * @tparam T Type of the value (trivially copyable).
+ */
+template<typename T>
+void writeBinary(std::ostream& stream, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "writeBinary() requires a trivially copyable type.");
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Reads a value written by writeBinary().
+ *
+ * @param stream Input stream.
+ * @return The value read.
+ * @tparam T Type of the value (trivially copyable).
+ */
+template<typename T>
+T readBinary(std::istream& stream) {
+    static_assert(std::is_trivially_copyable<T>::value, "readBinary() requires a trivially copyable type.");
+    T result;
+    stream.read(reinterpret_cast<char*>(&result), sizeof(T));
+    if (!stream) {
+        throw std::runtime_error("Unexpected end of binary stream.");
+    }
+    return result;
+}
+
+/**
+ * Writes a string (length, then characters).
+ *
+ * @param stream Output stream.
+ * @param[in] value String to write.
+ */
+inline void writeBinaryString(std::ostream& stream, const std::string& value) {
+    writeBinary<std::uint32_t>(stream, value.size());
+    stream.write(value.data(), value.size());
+}
+
+/**
+ * Reads a string written by writeBinaryString().
+ *
+ * @param stream Input stream.
+ * @return The string read.
+ */
+inline std::string readBinaryString(std::istream& stream) {
+    std::uint32_t length = readBinary<std::uint32_t>(stream);
+    std::string result(length, '\0');
+    stream.read(&result[0], length);
+    if (!stream) {
+        throw std::runtime_error("Unexpected end of binary stream.");
+    }
+    return result;
+}
+
+#endif /* BINARYSTREAM_HPP */
@@ -20,10 +20,10 @@
 #define BODY_HPP
 
 #include <memory>
+#include <vector>
 
 #include "btBulletDynamicsCommon.h"
 
-#include "BodyMoveListener.hpp"
 #include "lua/types/LuaTable.hpp"
 #include "lua/types/LuaVirtualClass.hpp"
 #include "Shape.hpp"
@@ -101,13 +101,107 @@ public:
      */
     Vector3<SI::InvAngularMass> getInvInertiaDiagLocal() const;
 
+    /**
+     * Tests if this body is deactivated (asleep) in the physics engine.
+     *
+     * Sleeping bodies are not simulated until something wakes them up (collision,
+     * teleport, joint motor...).
+     *
+     * @return True if this body is sleeping.
+     */
+    bool isSleeping() const {
+        return !body.isActive();
+    }
+
+    /**
+     * Sets the collision group & mask of this body.
+     *
+     * Two bodies can collide only if the group of each body shares a bit with the
+     * mask of the other one. Must be called before the body is added into a world.
+     *
+     * @param group Bitfield of the collision groups of this body.
+     * @param mask Bitfield of the collision groups this body collides with.
+     */
+    void setCollisionFilter(int group, int mask);
+
+    /**
+     * Gets the collision group of this body.
+     * @return The bitfield of the collision groups of this body.
+     */
+    int getCollisionGroup() const {
+        return collisionGroup;
+    }
+
+    /**
+     * Gets the collision mask of this body.
+     * @return The bitfield of the collision groups this body collides with.
+     */
+    int getCollisionMask() const {
+        return collisionMask;
+    }
+
+    /**
+     * Disables the collisions between this body and another body.
+     *
+     * The pair is rejected by the broadphase of the world: no contact is ever
+     * computed between the two bodies.
+     *
+     * @param other Body that should not collide with this one.
+     */
+    void disableCollisionsWith(Body& other);
+
+    /**
+     * Tests if the collisions with another body were disabled (see disableCollisionsWith()).
+     *
+     * Collision groups & masks are not tested by this function.
+     *
+     * @param other The other body.
+     * @return False if the collisions between the 2 bodies were disabled.
+     */
+    bool canCollideWith(const Body& other) const;
+
     /**
      * Gets a reference to the Bullet representation of this Body.
      *
+     * The user pointer of the Bullet body points to this object.
+     *
      * @return A reference to the internal Bullet Body.
      */
     btRigidBody& getBulletBody();
 
+    /**
+     * Creates a new body with the same shape & dynamic state as this one.
+     *
+     * The shape is shared. The new body is not in any world.
+     *
+     * @return The new body.
+     */
+    std::shared_ptr<Body> clone() const;
+
+    /**
+     * Copies the dynamic state (transform, velocities, activation) of another body.
+     *
+     * This body should not be in a world yet: its broadphase data is not updated.
+     *
+     * @param[in] source Body to copy.
+     */
+    void copyState(const Body& source);
+
+    /**
+     * Saves the dynamic state of this body (transform, velocities, activation).
+     *
+     * @param[out] data Bullet serialization structure receiving the state.
+     * @param serializer Bullet serializer.
+     */
+    void saveState(btRigidBodyData& data, btSerializer& serializer) const;
+
+    /**
+     * Restores the dynamic state of this body (transform, velocities, activation).
+     *
+     * @param[in] data State written by saveState().
+     */
+    void loadState(const btRigidBodyData& data);
+
     /**
      * Sets the world udpater of this object.
      *
@@ -136,18 +230,15 @@ public:
     }
 
     /**
-     * Adds a new listener for "move" events.
+     * Gets a shared pointer to the shape of this body.
      *
-     * @param listener The new listener.
-     */
-    void addMoveListener(BodyMoveListener& listener) const;
-
-    /**
-     * Removes listener for "move" events.
+     * Enables another thread to draw the shape, even after this body is destroyed.
      *
-     * @param listener The listener to remove.
+     * @return The shape of this body.
      */
-    void removeMoveListener(BodyMoveListener& listener) const;
+    std::shared_ptr<const Shape> getSharedShape() const {
+        return shape;
+    }
 
     virtual ~Body();
 private:
@@ -156,11 +247,17 @@ private:
     /** Shape of this body. */
     std::shared_ptr<Shape> shape;
     /** Object used by Bullet to communicate position & direction changes. */
-    mutable std::unique_ptr<MotionState> motionState;
+    std::unique_ptr<MotionState> motionState;
     /** Bullet body. */
     btRigidBody body;
     /** World callbacks to produce specific events when this object is in a world (can be null). */
     WorldUpdater* worldUpdater;
+    /** Bitfield of the collision groups of this body. */
+    int collisionGroup;
+    /** Bitfield of the collision groups this body collides with. */
+    int collisionMask;
+    /** Bodies that can't collide with this one (see disableCollisionsWith()). */
+    std::vector<Body*> collisionExceptions;
 
     /**
      * Sets the deactivation thresholds of this body.
@@ -24,7 +24,7 @@ class BodyCreationListener;
 #include "Body.hpp"
 #include "World.hpp"
 
-/** Interface to be informed of bodies creation by the physics engine. */
+/** Interface to be informed of bodies creation & deletion by the physics engine. */
 class BodyCreationListener {
 public:
     /**
@@ -34,6 +34,15 @@ public:
      */
     virtual void onBodyCreation(const Body& newBody) = 0;
 
+    /**
+     * Event triggered when a Body is removed from the physics engine.
+     *
+     * The body is still valid during this call.
+     *
+     * @param[in] body The removed body.
+     */
+    virtual void onBodyDeletion(const Body& body) = 0;
+
     virtual ~BodyCreationListener() = default;
 };
 
@@ -0,0 +1,115 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAPSULESHAPE_HPP
+#define CAPSULESHAPE_HPP
+
+#include <memory>
+
+#include "btBulletDynamicsCommon.h"
+
+#include "lua/types/LuaTable.hpp"
+#include "Shape.hpp"
+#include "units/Scalar.hpp"
+#include "units/SI.hpp"
+
+/**
+ * Capsule Shape: a cylinder closed by two half spheres.
+ *
+ * With a default transform, the capsule has a central axis aligned with the Y axis. It is centered on {0,0,0}.
+ *
+ * Contacts involving capsules are much cheaper than cylinders in the physics engine (they are
+ * computed as sphere-swept segments).
+ */
+class CapsuleShape : public Shape {
+public:
+    /**
+     * Creates a new capsule shape.
+     * @param mass Mass of this shape.
+     * @param radius Radius of the cylinder & half spheres.
+     * @param halfHeight Half length of the cylindric part (total length is 2*(halfHeight+radius)).
+     */
+    CapsuleShape(Scalar<SI::Mass> mass, Scalar<SI::Length> radius, Scalar<SI::Length> halfHeight);
+
+    /**
+     * Creates a new capsule shape.
+     * @param density Density of this shape.
+     * @param radius Radius of the cylinder & half spheres.
+     * @param halfHeight Half length of the cylindric part (total length is 2*(halfHeight+radius)).
+     */
+    CapsuleShape(Scalar<SI::Density> density, Scalar<SI::Length> radius, Scalar<SI::Length> halfHeight);
+
+    virtual ~CapsuleShape();
+
+    /**
+     * Gets the radius of this capsule.
+     * @return The radius of this capsule.
+     */
+    Scalar<SI::Length> getRadius() const;
+
+    /**
+     * Gets the half length of the cylindric part of this capsule.
+     * @return The half height of this capsule.
+     */
+    Scalar<SI::Length> getHalfHeight() const;
+
+    btCollisionShape& getBulletShape() override;
+
+    const btCollisionShape& getBulletShape() const override;
+
+    /**
+     * Gets the exact moments of inertia of this capsule.
+     *
+     * Bullet approximates a capsule by its bounding box, which overestimates the inertia of thin limbs.
+     * @return The inertia vector of this shape, in engine units.
+     */
+    btVector3 getEngineInertia() const override;
+
+    void draw(ShapeDrawer& drawer, const btTransform& transform) const override;
+
+    int luaIndex(const std::string& memberName, LuaStateView& state) override;
+
+    /**
+     * Creates a new CapsuleShape from a Lua table.
+     * @param table Lua table containing the parameters of the new shape.
+     * @return A CapsuleShape object, shared with the other identical shapes.
+     */
+    static std::shared_ptr<CapsuleShape> luaGetFromTable(LuaTable& table);
+
+    /**
+     * Gets a capsule shape from the global ShapeCache, creating it if needed.
+     * @param mass Mass of the shape.
+     * @param radius Radius of the capsule.
+     * @param halfHeight Half length of the cylindric part of the capsule.
+     * @return A capsule shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<CapsuleShape> makeShared(Scalar<SI::Mass> mass, Scalar<SI::Length> radius, Scalar<SI::Length> halfHeight);
+
+    /**
+     * Gets a capsule shape from the global ShapeCache, creating it if needed.
+     * @param density Density of the shape.
+     * @param radius Radius of the capsule.
+     * @param halfHeight Half length of the cylindric part of the capsule.
+     * @return A capsule shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<CapsuleShape> makeShared(Scalar<SI::Density> density, Scalar<SI::Length> radius, Scalar<SI::Length> halfHeight);
+private:
+    btCapsuleShape shape;
+};
+
+#endif /* CAPSULESHAPE_HPP */
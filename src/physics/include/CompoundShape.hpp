@@ -62,7 +62,18 @@ public:
      * @param table Lua table containing the shape parameters.
      * @return The new CompoundShape object.
      */
-    static std::unique_ptr<CompoundShape> luaGetFromTable(LuaTable& table);
+    static std::shared_ptr<CompoundShape> luaGetFromTable(LuaTable& table);
+
+    /**
+     * Gets a compound shape from the global ShapeCache, creating it if needed.
+     *
+     * Children are compared by address: identical compounds are only merged if
+     * their children are themselves shared.
+     *
+     * @param constructionInfo List of child & their transform.
+     * @return A compound shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<CompoundShape> makeShared(const std::vector<ChildInfo>& constructionInfo);
 private:
     /** Bullet shape. */
     btCompoundShape shape;
@@ -19,8 +19,13 @@
 #ifndef CONSTRAINT_HPP
 #define CONSTRAINT_HPP
 
+#include <istream>
+#include <optional>
+#include <ostream>
+
 #include "btBulletDynamicsCommon.h"
 
+#include "JointKernel.hpp"
 #include "units/Scalar.hpp"
 #include "units/BulletUnits.hpp"
 
@@ -40,10 +45,55 @@ public:
     /**
      * Method called by the World containing this object before each integration step.
      *
+     * Not called for constraints registered in the JointKernel of the world (see addToKernel()).
+     *
      * @param world World containing this constraint.
      * @param timeStep Duration of the next integration step.
      */
-    virtual void beforeTick(World& world, Scalar<BulletUnits::Time> timeStep) = 0;
+    virtual void beforeTick(World& world, Scalar<BulletUnits::Time> timeStep) {
+
+    }
+
+    /**
+     * Registers the friction & motor of this constraint into the batched kernel of a World.
+     *
+     * Called once, when this constraint is added to a world.
+     *
+     * @param kernel Joint kernel of the world.
+     * @return The handle of this constraint in the kernel, or nothing if beforeTick() should be used instead.
+     */
+    virtual std::optional<JointKernel::Handle> addToKernel(JointKernel& kernel) {
+        return std::nullopt;
+    }
+
+    /**
+     * Unregisters this constraint from the batched kernel of a World.
+     *
+     * Called when this constraint is removed from a world, if addToKernel() returned a handle.
+     *
+     * @param kernel Joint kernel of the world.
+     */
+    virtual void removeFromKernel(JointKernel& kernel) {
+
+    }
+
+    /**
+     * Writes the internal state of this constraint not stored in the bodies (ex: motor torque).
+     *
+     * @param stream Binary output stream.
+     */
+    virtual void saveState(std::ostream& stream) const {
+
+    }
+
+    /**
+     * Reads the state written by saveState().
+     *
+     * @param stream Binary input stream.
+     */
+    virtual void loadState(std::istream& stream) {
+
+    }
 };
 
 #endif /* CONSTRAINT_HPP */
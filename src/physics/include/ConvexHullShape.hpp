@@ -19,11 +19,14 @@
 #ifndef CONVEXHULLSHAPE_HPP
 #define CONVEXHULLSHAPE_HPP
 
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "btBulletDynamicsCommon.h"
 
+#include "ConvexMesh.hpp"
 #include "lua/types/LuaTable.hpp"
 #include "Shape.hpp"
 #include "units/Scalar.hpp"
@@ -35,10 +38,15 @@ class ConvexHullShape : public Shape {
 public:
     /**
      * Creates a new ConvexHullShape.
+     *
+     * If maxVertices is not 0, the hull is simplified before building the Bullet shape: see
+     * getSimplificationError().
+     *
      * @param mass Mass of the shape.
      * @param vertices Vertices of the convex mesh.
+     * @param maxVertices Maximum number of vertices of the hull (0: no limit, otherwise at least 4).
      */
-    ConvexHullShape(Scalar<SI::Mass> mass, const std::vector<Vector3<SI::Length>>& vertices);
+    ConvexHullShape(Scalar<SI::Mass> mass, const std::vector<Vector3<SI::Length>>& vertices, std::size_t maxVertices = 0);
 
     virtual ~ConvexHullShape();
 
@@ -48,15 +56,51 @@ public:
 
     void draw(ShapeDrawer& drawer, const btTransform& transform) const override;
 
+    /**
+     * Gets the error introduced by the simplification of the hull (see the maxVertices constructor argument).
+     *
+     * The simplified hull is inside the hull of the input vertices.
+     *
+     * @return An upper bound of the distance between the input vertices and the hull of this shape.
+     */
+    Scalar<SI::Length> getSimplificationError() const;
+
+    int luaIndex(const std::string& memberName, LuaStateView& state) override;
+
+    /**
+     * Gets the mesh used to render this shape (hull extruded by the collision margin).
+     *
+     * The mesh is computed on the first call, then shared by all the bodies using this shape.
+     * Thread-safe.
+     *
+     * @return The render mesh of this shape.
+     */
+    const std::shared_ptr<const ConvexMesh>& getRenderMesh() const;
+
     /**
      * Creates anew ConvexHullShape from a Lua table.
      * @param table Lua table containing the parameters of this shape.
-     * @return The new CuboidShape.
+     * @return A ConvexHullShape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<ConvexHullShape> luaGetFromTable(LuaTable& table);
+
+    /**
+     * Gets a convex hull shape from the global ShapeCache, creating it if needed.
+     * @param mass Mass of the shape.
+     * @param vertices Points whose convex hull defines the shape.
+     * @param maxVertices Maximum number of vertices of the hull (0: no limit).
+     * @return A convex hull shape, shared with the other identical shapes.
      */
-    static std::unique_ptr<ConvexHullShape> luaGetFromTable(LuaTable& table);
+    static std::shared_ptr<ConvexHullShape> makeShared(Scalar<SI::Mass> mass, const std::vector<Vector3<SI::Length>>& vertices, std::size_t maxVertices = 0);
 private:
     /** Bullet shape. */
     btConvexHullShape shape;
+    /** Value of getSimplificationError() (in engine units). */
+    btScalar simplificationError = 0;
+    /** Flag used to compute renderMesh only once. */
+    mutable std::once_flag renderMeshFlag;
+    /** Cached result of getRenderMesh() (null until the first call). */
+    mutable std::shared_ptr<const ConvexMesh> renderMesh;
 };
 
 #endif /* CONVEXHULLSHAPE_HPP */
@@ -19,16 +19,17 @@
 #ifndef CONVEXMESH_HPP
 #define CONVEXMESH_HPP
 
-#include <functional>
-#include <memory>
-#include <unordered_set>
+#include <cstddef>
 #include <vector>
 
 #include "btBulletDynamicsCommon.h"
 
-#include "MeshTriangle.hpp"
-
-/** Convex mesh from the physics engine. */
+/**
+ * Convex mesh from the physics engine.
+ *
+ * The mesh is the convex hull of a set of points, computed with the Quickhull algorithm.
+ * It is stored as flat arrays: vertices, triangle indices & triangle normals.
+ */
 class ConvexMesh {
 public:
     /**
@@ -39,10 +40,24 @@ public:
 
     /**
      * Creates a new Mesh from the vertices of a convex hull (move constructor).
+     *
+     * Points strictly inside the hull are allowed, and dropped from the mesh.
+     *
      * @param vertices Vertices of the convex hull.
      */
     ConvexMesh(std::vector<btVector3>&& vertices);
 
+    /**
+     * Creates a new Mesh approximating the convex hull of a set of points.
+     *
+     * Points are inserted farthest first, until the budget is reached: the result is
+     * inside the exact hull, and no input point is farther than getError() from it.
+     *
+     * @param vertices Points whose convex hull is approximated.
+     * @param maxVertices Maximum number of vertices of the mesh (at least 4).
+     */
+    ConvexMesh(const std::vector<btVector3>& vertices, std::size_t maxVertices);
+
     /**
      * Extrude all faces along their normals on the given distance.
      *
@@ -53,34 +68,65 @@ public:
     void addMargin(btScalar margin);
 
     /**
-     * Gets the set of triangles of this mesh.
+     * Gets the vertices of this mesh.
+     *
+     * Only the points on the hull are kept: every vertex is used by at least one triangle.
+     *
+     * @return The vertices of this mesh.
+     */
+    const std::vector<btVector3>& getVertices() const {
+        return vertices;
+    }
+
+    /**
+     * Gets the triangles of this mesh.
      *
      * <ul>
-     * <li>The normal of a triangle is directed to the outside of the mesh.</li>
+     * <li>Triangle <code>i</code> is made of the vertices at <code>3*i</code>, <code>3*i+1</code>, <code>3*i+2</code>.</li>
      * <li>Seen from outside the mesh, vertices of a triangle are stored in CCW order (counter clockwise).</li>
      * </ul>
      *
-     * @return The set of triangles of this mesh.
+     * @return Indices (in getVertices()) of the vertices of each triangle.
      */
-    const std::unordered_set<std::unique_ptr<MeshTriangle>>& getTriangles() const {
-        return triangles;
+    const std::vector<unsigned>& getIndices() const {
+        return indices;
     }
-private:
-    /** List of vertices. */
-    std::vector<btVector3> vertices;
-    /** List of triangles (see getTriangles() for constraints on its content). */
-    std::unordered_set<std::unique_ptr<MeshTriangle>> triangles;
-    /** An arbitrary point which is strictly inside the convex mesh. */
-    btVector3 center;
 
     /**
-     * Adds a new vertex to the current convex mesh.
+     * Gets the normals of the triangles of this mesh.
      *
-     * Used to build incrementally a mesh from a convex hull.
+     * The normal of a triangle is normalized, and directed to the outside of the mesh.
      *
-     * @param vertex Vertex to add.
+     * @return The normal of each triangle.
+     */
+    const std::vector<btVector3>& getNormals() const {
+        return normals;
+    }
+
+    /**
+     * Gets the number of triangles of this mesh.
+     * @return The number of triangles.
      */
-    void addVertex(const btVector3& vertex);
+    std::size_t getTriangleCount() const {
+        return normals.size();
+    }
+
+    /**
+     * Gets the approximation error of this mesh.
+     * @return An upper bound of the distance between the input points and this mesh (0 if exact).
+     */
+    btScalar getError() const {
+        return error;
+    }
+private:
+    /** List of vertices. */
+    std::vector<btVector3> vertices;
+    /** Vertex indices of the triangles (see getIndices() for constraints on its content). */
+    std::vector<unsigned> indices;
+    /** Normal of each triangle. */
+    std::vector<btVector3> normals;
+    /** Value of getError(). */
+    btScalar error = 0;
 };
 
 #endif /* CONVEXMESH_HPP */
@@ -67,7 +67,23 @@ public:
      * @param table Lua table containing the parameters of this shape.
      * @return The new CuboidShape.
      */
-    static std::unique_ptr<CuboidShape> luaGetFromTable(LuaTable& table);
+    static std::shared_ptr<CuboidShape> luaGetFromTable(LuaTable& table);
+
+    /**
+     * Gets a cuboid shape from the global ShapeCache, creating it if needed.
+     * @param mass Mass of the shape.
+     * @param halfExtents Half extents of the cuboid.
+     * @return A cuboid shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<CuboidShape> makeShared(Scalar<SI::Mass> mass, const Vector3<SI::Length>& halfExtents);
+
+    /**
+     * Gets a cuboid shape from the global ShapeCache, creating it if needed.
+     * @param density Density of the shape.
+     * @param halfExtents Half extents of the cuboid.
+     * @return A cuboid shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<CuboidShape> makeShared(Scalar<SI::Density> density, const Vector3<SI::Length>& halfExtents);
 private:
     /** Bullt shape. */
     btBoxShape shape;
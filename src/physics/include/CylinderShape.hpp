@@ -71,7 +71,23 @@ public:
      * @param table Lua table containing the parameters of the new shape.
      * @return The new shape.
      */
-    static std::unique_ptr<CylinderShape> luaGetFromTable(LuaTable& table);
+    static std::shared_ptr<CylinderShape> luaGetFromTable(LuaTable& table);
+
+    /**
+     * Gets a cylinder shape from the global ShapeCache, creating it if needed.
+     * @param mass Mass of the shape.
+     * @param halfExtents Half extents of the cylinder.
+     * @return A cylinder shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<CylinderShape> makeShared(Scalar<SI::Mass> mass, const Vector3<SI::Length>& halfExtents);
+
+    /**
+     * Gets a cylinder shape from the global ShapeCache, creating it if needed.
+     * @param density Density of the shape.
+     * @param halfExtents Half extents of the cylinder.
+     * @return A cylinder shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<CylinderShape> makeShared(Scalar<SI::Density> density, const Vector3<SI::Length>& halfExtents);
 private:
     btCylinderShape shape;
 };
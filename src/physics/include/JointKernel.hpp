@@ -0,0 +1,127 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOINTKERNEL_HPP
+#define JOINTKERNEL_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "btBulletDynamicsCommon.h"
+
+/**
+ * Batched computation of the friction & motor torques of the angular joints of a world.
+ *
+ * The parameters & state of all joints are stored in this object, and processed in a
+ * single loop without virtual calls. The inverse inertia of the bodies is read at each
+ * run(): changes of mass or inertia are taken into account.
+ *
+ * Each joint links a convex body & a concave body. Its frame is fixed relative to the
+ * convex body. Around each axis of this frame, the joint applies a viscous friction
+ * (torque proportional to the relative angular velocity of the two bodies, clamped so
+ * that it never reverses this velocity), and a motor torque.
+ *
+ * All values are in Bullet units.
+ */
+class JointKernel {
+public:
+    /** Identifier of a joint in a kernel (stable when the kernel is reordered). */
+    using Handle = std::size_t;
+
+    /**
+     * Adds a new joint into this kernel.
+     *
+     * @param convexBody Body holding the convex part of the joint (defines the joint frame).
+     * @param concaveBody Body holding the concave part of the joint.
+     * @param[in] jointBasis Orientation of the joint frame, relative to the convex body.
+     * @param[in] frictionCoefficients Friction coefficient around each axis of the joint frame.
+     * @param[in] axes Axes of the joint frame handled by this joint (1: handled, 0: ignored).
+     * @return The handle of the new joint.
+     */
+    Handle add(btRigidBody& convexBody, btRigidBody& concaveBody, const btMatrix3x3& jointBasis,
+               const btVector3& frictionCoefficients, const btVector3& axes);
+
+    /**
+     * Removes a joint from this kernel.
+     *
+     * The order of the other joints is preserved. The handle can be reused by a later add().
+     *
+     * @param handle Joint to remove.
+     */
+    void remove(Handle handle);
+
+    /**
+     * Sets the torque of the motor of a joint.
+     *
+     * @param handle Joint to update.
+     * @param[in] torque Torque applied by the concave body on the convex body (joint frame).
+     */
+    void setMotorTorque(Handle handle, const btVector3& torque) {
+        motorTorques[slots[handle]] = torque;
+    }
+
+    /**
+     * Reorders the joints of this kernel.
+     *
+     * Used to store groups of joints in contiguous ranges (see run()).
+     *
+     * @param[in] order Handles of all the joints of this kernel, in their new order.
+     */
+    void reorder(const std::vector<Handle>& order);
+
+    /**
+     * Applies friction impulses & motor torques of a range of joints.
+     *
+     * Joints are processed in order: friction impulses of a joint are visible
+     * to the next joints sharing a body.
+     *
+     * @param[in] begin Position of the first joint to process.
+     * @param[in] end Position after the last joint to process.
+     * @param[in] timeStep Duration of the next integration step.
+     */
+    void run(std::size_t begin, std::size_t end, btScalar timeStep);
+
+    /**
+     * Gets the number of joints in this kernel.
+     * @return The number of joints.
+     */
+    std::size_t size() const {
+        return convexBodies.size();
+    }
+private:
+    /** Position of each joint in the arrays below (index: handle). */
+    std::vector<std::size_t> slots;
+    /** Handle of the joint stored at each position. */
+    std::vector<Handle> handles;
+    /** Handles of the removed joints (reused by add()). */
+    std::vector<Handle> freeHandles;
+    /** Bodies holding the convex part of the joints. */
+    std::vector<btRigidBody*> convexBodies;
+    /** Bodies holding the concave part of the joints. */
+    std::vector<btRigidBody*> concaveBodies;
+    /** Orientations of the joint frames, relative to the convex bodies. */
+    std::vector<btMatrix3x3> jointBases;
+    /** Axes of the joint frames handled by the joints (1: handled, 0: ignored). */
+    std::vector<btVector3> jointAxes;
+    /** Friction coefficients (joint frame, 0 on ignored axes). */
+    std::vector<btVector3> frictionCoefficients;
+    /** Motor torques (joint frame, 0 on ignored axes). */
+    std::vector<btVector3> motorTorques;
+};
+
+#endif /* JOINTKERNEL_HPP */
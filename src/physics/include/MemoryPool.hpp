@@ -0,0 +1,137 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMORYPOOL_HPP
+#define MEMORYPOOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Recycles memory blocks of objects that are often destroyed & recreated (bodies, joints).
+ *
+ * Freed blocks are kept in a free list (one per block size) instead of being returned to
+ * the system, so that respawning objects of the same types doesn't hit the global allocator.
+ * All blocks are aligned for Bullet's SIMD types. Thread-safe.
+ */
+class MemoryPool {
+public:
+    /** Alignment of all the blocks of a pool. */
+    static constexpr std::size_t ALIGNMENT = 16;
+
+    /**
+     * Gets the pool shared by the whole process.
+     *
+     * This pool is never destroyed: objects can be freed by static destructors.
+     *
+     * @return The global pool.
+     */
+    static MemoryPool& global();
+
+    /**
+     * Gets a memory block.
+     *
+     * @param[in] size Size of the block (in bytes).
+     * @return A block of the requested size (recycled if possible).
+     */
+    void* allocate(std::size_t size);
+
+    /**
+     * Puts back a block into this pool.
+     *
+     * @param block Block returned by allocate().
+     * @param[in] size Size passed to allocate().
+     */
+    void deallocate(void* block, std::size_t size);
+
+    /**
+     * Gets the number of blocks ready to be recycled.
+     * @return The number of free blocks held by this pool.
+     */
+    std::size_t getFreeCount() const;
+
+    MemoryPool() = default;
+
+    MemoryPool(const MemoryPool&) = delete;
+
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    ~MemoryPool();
+private:
+    /** Mutex protecting freeBlocks. */
+    mutable std::mutex mutex;
+    /** Free blocks (key: size of the blocks). */
+    std::unordered_map<std::size_t, std::vector<void*>> freeBlocks;
+};
+
+/**
+ * Standard allocator using MemoryPool::global().
+ *
+ * @tparam T Type of the allocated objects.
+ */
+template<typename T>
+class PoolAllocator {
+public:
+    static_assert(alignof(T) <= MemoryPool::ALIGNMENT, "PoolAllocator: unsupported alignment.");
+
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) {
+
+    }
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(MemoryPool::global().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* block, std::size_t n) {
+        MemoryPool::global().deallocate(block, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const {
+        return false;
+    }
+};
+
+/**
+ * Creates a shared object whose storage (object & control block) is recycled by MemoryPool::global().
+ *
+ * @param args Arguments of the constructor of T.
+ * @return The new object.
+ * @tparam T Type of the new object.
+ */
+template<typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+#endif /* MEMORYPOOL_HPP */
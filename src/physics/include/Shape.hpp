@@ -75,9 +75,11 @@ public:
 
     /**
      * Gets the moments of inertia of this shape, in engine units.
+     *
+     * The default implementation uses the approximation of the Bullet shape.
      * @return The inertia vector of this shape.
      */
-    btVector3 getEngineInertia() const;
+    virtual btVector3 getEngineInertia() const;
 
     /**
      * Gets the moments of inertia of this shape.
@@ -89,9 +91,9 @@ public:
 
     /**
      * Constructs a Shape type from a Lua table.
-     * @return A Shape (or derived type) constructed from the content of the table.
+     * @return A Shape (or derived type) built from the content of the table, shared with the other identical shapes.
      */
-    static std::unique_ptr<Shape> luaGetFromTable(LuaTable& table);
+    static std::shared_ptr<Shape> luaGetFromTable(LuaTable& table);
 protected:
     /** Mass of this shape. */
     Scalar<SI::Mass> mass;
@@ -0,0 +1,173 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHAPECACHE_HPP
+#define SHAPECACHE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "btBulletDynamicsCommon.h"
+
+#include "Shape.hpp"
+
+/**
+ * Interning table of shapes.
+ *
+ * Shapes are immutable: structurally identical shapes (same type, same parameters)
+ * can be shared by all the bodies of all the worlds. The cache only holds weak
+ * references: a shape is destroyed when no body or construction info uses it anymore.
+ * Thread-safe.
+ */
+class ShapeCache {
+public:
+    /** Identifier of a shape: type name followed by the raw bytes of its parameters (engine units). */
+    class Key {
+    public:
+        /**
+         * Creates a new key.
+         * @param[in] type Name of the type of the shape.
+         */
+        explicit Key(const char* type) : data(type) {
+            data.push_back('\0');
+        }
+
+        /**
+         * Appends a scalar parameter to this key.
+         * @param[in] value Value of the parameter.
+         * @return This key.
+         */
+        Key& add(btScalar value) {
+            char bytes[sizeof(btScalar)];
+            std::memcpy(bytes, &value, sizeof(btScalar));
+            data.append(bytes, sizeof(btScalar));
+            return *this;
+        }
+
+        /**
+         * Appends an integer parameter to this key.
+         * @param[in] value Value of the parameter.
+         * @return This key.
+         */
+        Key& add(std::size_t value) {
+            char bytes[sizeof(std::size_t)];
+            std::memcpy(bytes, &value, sizeof(std::size_t));
+            data.append(bytes, sizeof(std::size_t));
+            return *this;
+        }
+
+        /**
+         * Appends a vector parameter to this key.
+         * @param[in] value Value of the parameter.
+         * @return This key.
+         */
+        Key& add(const btVector3& value) {
+            return add(value.x()).add(value.y()).add(value.z());
+        }
+
+        /**
+         * Appends a transform parameter to this key.
+         * @param[in] value Value of the parameter.
+         * @return This key.
+         */
+        Key& add(const btTransform& value) {
+            const btMatrix3x3& basis = value.getBasis();
+            return add(basis[0]).add(basis[1]).add(basis[2]).add(value.getOrigin());
+        }
+
+        /**
+         * Appends a shape parameter (ex: child of a compound) to this key.
+         *
+         * Interned shapes are compared by address.
+         *
+         * @param[in] value Value of the parameter.
+         * @return This key.
+         */
+        Key& add(const Shape& value) {
+            const Shape* ptr = &value;
+            char bytes[sizeof(ptr)];
+            std::memcpy(bytes, &ptr, sizeof(ptr));
+            data.append(bytes, sizeof(ptr));
+            return *this;
+        }
+
+        /**
+         * Gets the content of this key.
+         * @return The bytes of this key.
+         */
+        const std::string& getData() const {
+            return data;
+        }
+    private:
+        /** Content of this key. */
+        std::string data;
+    };
+
+    /**
+     * Gets the cache shared by the whole process.
+     * @return The global cache.
+     */
+    static ShapeCache& global();
+
+    /**
+     * Gets the shape matching a key, creating it if needed.
+     *
+     * @param[in] key Identifier of the shape.
+     * @param factory Function creating the shape if it is not in the cache.
+     * @return The cached shape.
+     * @tparam T Type of the shape (must be the same for all the calls with the same key type name).
+     * @tparam Factory Type of the factory (returns a std::shared_ptr<T> or std::unique_ptr<T>).
+     */
+    template<typename T, typename Factory>
+    std::shared_ptr<T> get(const Key& key, Factory&& factory) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::weak_ptr<Shape>& entry = entries[key.getData()];
+        std::shared_ptr<Shape> cached = entry.lock();
+        if (cached != nullptr) {
+            return std::static_pointer_cast<T>(cached);
+        }
+        std::shared_ptr<T> result = factory();
+        entry = result;
+        if (entries.size() >= 2 * purgeSize) {
+            purge();
+        }
+        return result;
+    }
+
+    /**
+     * Gets the number of shapes currently interned.
+     * @return The number of cached shapes still in use.
+     */
+    std::size_t size() const;
+private:
+    /** Mutex protecting the fields of this object. */
+    mutable std::mutex mutex;
+    /** Interned shapes. */
+    std::unordered_map<std::string, std::weak_ptr<Shape>> entries;
+    /** Number of entries left by the last purge. */
+    std::size_t purgeSize = 16;
+
+    /** Removes the entries of destroyed shapes. */
+    void purge();
+};
+
+#endif /* SHAPECACHE_HPP */
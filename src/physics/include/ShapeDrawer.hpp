@@ -19,6 +19,8 @@
 #ifndef SHAPEDRAWER_HPP
 #define SHAPEDRAWER_HPP
 
+#include <memory>
+
 #include "btBulletDynamicsCommon.h"
 
 #include "ConvexMesh.hpp"
@@ -57,6 +59,18 @@ public:
      */
     virtual void drawCylinder(const btTransform& transform, const btVector3& halfExtents) = 0;
 
+    /**
+     * Draw a capsule.
+     *
+     * With a default transform, the capsule has a central axis aligned with the Y axis.
+     * It is centered on {0,0,0}.
+     *
+     * @param[in] transform Position & orientation of the capsule.
+     * @param[in] radius Radius of the cylinder & of the half spheres.
+     * @param[in] halfHeight Half length of the cylindric part.
+     */
+    virtual void drawCapsule(const btTransform& transform, btScalar radius, btScalar halfHeight) = 0;
+
     /**
      * Draw a cuboid.
      *
@@ -68,11 +82,13 @@ public:
     /**
      * Draws a convex mesh.
      *
+     * The mesh is shared by all the bodies using the same shape: drawers can cache
+     * their own representation of it (as long as the mesh is alive).
+     *
      * @param transform Position & orientation of the convex mesh.
-     * @param vertices
-     * @param faces
+     * @param mesh Mesh to draw.
      */
-    virtual void drawMesh(const btTransform& transform, const ConvexMesh& mesh) = 0;
+    virtual void drawMesh(const btTransform& transform, const std::shared_ptr<const ConvexMesh>& mesh) = 0;
 
     virtual ~ShapeDrawer() = default;
 };
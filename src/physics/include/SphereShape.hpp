@@ -64,9 +64,25 @@ public:
     /**
      * Constructs a SphereShape object from a Lua table.
      * @param table Lua table containing the parameters of this shape.
-     * @return The new SphereShape object.
+     * @return A SphereShape object, shared with the other identical shapes.
      */
-    static std::unique_ptr<SphereShape> luaGetFromTable(LuaTable& table);
+    static std::shared_ptr<SphereShape> luaGetFromTable(LuaTable& table);
+
+    /**
+     * Gets a sphere shape from the global ShapeCache, creating it if needed.
+     * @param mass Mass of the shape.
+     * @param radius Radius of the sphere.
+     * @return A sphere shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<SphereShape> makeShared(Scalar<SI::Mass> mass, Scalar<SI::Length> radius);
+
+    /**
+     * Gets a sphere shape from the global ShapeCache, creating it if needed.
+     * @param density Density of the shape.
+     * @param radius Radius of the sphere.
+     * @return A sphere shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<SphereShape> makeShared(Scalar<SI::Density> density, Scalar<SI::Length> radius);
 private:
     /** Bullet shape. */
     btSphereShape shape;
@@ -67,7 +67,15 @@ public:
      * @param table Lua table containing the parameters of the new shape.
      * @return The new shape.
      */
-    static std::unique_ptr<StaticPlaneShape> luaGetFromTable(LuaTable& table);
+    static std::shared_ptr<StaticPlaneShape> luaGetFromTable(LuaTable& table);
+
+    /**
+     * Gets a static plane shape from the global ShapeCache, creating it if needed.
+     * @param normal Normal vector of the plane.
+     * @param offset Distance of the plane from the origin, along the normal.
+     * @return A static plane shape, shared with the other identical shapes.
+     */
+    static std::shared_ptr<StaticPlaneShape> makeShared(const Vector3<SI::NoUnit>& normal, Scalar<SI::Length> offset);
 private:
     /** Bullet shape. */
     btStaticPlaneShape shape;
@@ -0,0 +1,148 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRANSFORMBUFFER_HPP
+#define TRANSFORMBUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "btBulletDynamicsCommon.h"
+
+class Body;
+class Shape;
+
+/**
+ * Lock-free triple buffer of body transforms.
+ *
+ * A single producer (the thread stepping the world) publishes snapshots of the
+ * positions & orientations of bodies. A single consumer (the render thread) reads
+ * the most recent snapshot. Neither side ever waits for the other: the producer
+ * always owns a free buffer to write into, and the consumer keeps its buffer until
+ * a newer one has been published.
+ *
+ * The producer can detect whether its previous snapshot was read (see publish()),
+ * which allows snapshots to hold only the bodies moved since the last snapshot read
+ * by the consumer.
+ *
+ * Snapshots can also hold the bodies added & removed since the last snapshot read:
+ * the consumer learns about new bodies in the same snapshot as their first transform.
+ */
+class TransformBuffer {
+public:
+    /** Position & orientation of a body. */
+    struct Entry {
+        /**
+         * Creates a new entry.
+         * @param[in] body Body whose transform is stored.
+         * @param[in] transform Position & orientation of the body.
+         */
+        Entry(const Body& body, const btTransform& transform) :
+            body(&body),
+            transform(transform)
+        {
+
+        }
+
+        /** Body whose transform is stored (only usable as a key by the consumer). */
+        const Body* body;
+        /** Position & orientation of the body. */
+        btTransform transform;
+    };
+
+    /** Body added to or removed from a world. */
+    struct BodyEvent {
+        /**
+         * Creates a new event.
+         * @param[in] body Body added or removed.
+         * @param[in] shape Shape of the added body (null if the body was removed).
+         */
+        BodyEvent(const Body& body, std::shared_ptr<const Shape> shape) :
+            body(&body),
+            shape(std::move(shape))
+        {
+
+        }
+
+        /** Body added or removed (only usable as a key by the consumer). */
+        const Body* body;
+        /** Shape of the added body (null if the body was removed). */
+        std::shared_ptr<const Shape> shape;
+    };
+
+    /** State of a set of bodies of a world at a given time. */
+    struct Snapshot {
+        /**
+         * Bodies added & removed, in chronological order.
+         *
+         * They must be handled before the transforms: the address of a removed body
+         * can be reused by a body added after it.
+         */
+        std::vector<BodyEvent> events;
+        /** Transforms of the bodies (all in the world when the snapshot was made). */
+        std::vector<Entry> transforms;
+    };
+
+    /** Creates a new buffer, with no published snapshot. */
+    TransformBuffer();
+
+    /**
+     * Gets the buffer owned by the producer.
+     *
+     * It must be filled with a full snapshot before calling publish().
+     *
+     * @return The snapshot that will be published on the next publish() call.
+     */
+    Snapshot& getWriteBuffer() {
+        return buffers[writeIndex];
+    }
+
+    /**
+     * Makes the content of the write buffer available to the consumer.
+     *
+     * The producer gets a new write buffer (with unspecified content).
+     *
+     * @return True if the snapshot replaced by this call was read by the consumer (or if there was none).
+     */
+    bool publish();
+
+    /**
+     * Gets the most recently published snapshot.
+     *
+     * @return The latest snapshot, or nullptr if nothing was published since the last call.
+     */
+    const Snapshot* readNew();
+private:
+    /** Flag set in the shared index when its buffer has not been read yet. */
+    static constexpr unsigned FRESH_FLAG = 4;
+    /** Mask to get a buffer index from the shared index. */
+    static constexpr unsigned INDEX_MASK = 3;
+
+    /** Storage of the 3 snapshots. */
+    std::array<Snapshot, 3> buffers;
+    /** Index of the buffer owned by the producer. */
+    unsigned writeIndex;
+    /** Index (and FRESH_FLAG) of the buffer exchanged between the producer & the consumer. */
+    std::atomic<unsigned> sharedIndex;
+    /** Index of the buffer owned by the consumer. */
+    unsigned readIndex;
+};
+
+#endif /* TRANSFORMBUFFER_HPP */
@@ -19,15 +19,24 @@
 #ifndef WORLD_HPP
 #define WORLD_HPP
 
+#include <chrono>
+#include <cstdint>
+#include <istream>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "btBulletDynamicsCommon.h"
 
 #include "Body.hpp"
 #include "BodyCreationListener.hpp"
 #include "Constraint.hpp"
+#include "JointKernel.hpp"
 #include "lua/types/LuaVirtualClass.hpp"
+#include "TransformBuffer.hpp"
 #include "units/BulletUnits.hpp"
 #include "units/Scalar.hpp"
 #include "units/SI.hpp"
@@ -42,11 +51,184 @@
 class World : public LuaVirtualClass {
 public:
     /** Constant iterator over all the bodies of this engine. */
-    using const_iterator = std::unordered_set<std::shared_ptr<Body>>::const_iterator;
+    using const_iterator = std::vector<std::shared_ptr<Body>>::const_iterator;
+
+    /**
+     * Groups the teleports of bodies of a world (Body::setEngineTransform() & co).
+     *
+     * While at least one batch exists, moved bodies are not updated in the broadphase.
+     * When the last batch is destroyed, the broadphase is updated once, and only the
+     * bodies overlapping the old or new positions of the moved bodies are woken up.
+     */
+    class TransformBatch {
+    public:
+        /**
+         * Starts a new batch.
+         * @param world World containing the bodies that will be moved.
+         */
+        TransformBatch(World& world);
+
+        TransformBatch(const TransformBatch&) = delete;
+
+        TransformBatch& operator=(const TransformBatch&) = delete;
+
+        /** Ends this batch. */
+        ~TransformBatch();
+    private:
+        /** World containing the moved bodies. */
+        World& world;
+    };
+
+    /** Construction parameters of a World. */
+    struct Settings {
+        /** Broadphase algorithms (pair search on the bounding boxes of the bodies). */
+        enum class Broadphase {
+            /** Dynamic bounding volume trees (btDbvtBroadphase): no bounds, good default. */
+            Dbvt,
+            /**
+             * Sweep & prune on quantized axes (bt32BitAxisSweep3).
+             *
+             * Requires worldMin & worldMax. Efficient for large worlds with few moving bodies.
+             * Preallocates maxBodies handles (about 140 bytes each).
+             */
+            AxisSweep,
+        };
+
+        /** Creates the default settings (single-threaded world). */
+        Settings() :
+            threads(1),
+            broadphase(Broadphase::Dbvt),
+            worldMin(-1000, -1000, -1000),
+            worldMax(1000, 1000, 1000),
+            maxBodies(16384),
+            solverIterations(10),
+            fixedTimeStep(1.0/240),
+            maxSubSteps(4),
+            splitImpulse(true),
+            manifoldPoolSize(4096),
+            algorithmPoolSize(4096)
+        {
+
+        }
+
+        /**
+         * Number of threads stepping the world.
+         *
+         * 1 creates a single-threaded btDiscreteDynamicsWorld. More creates a
+         * btDiscreteDynamicsWorldMt (requires Bullet built with BT_THREADSAFE).
+         * Bullet's task scheduler is global: multithreaded worlds are never stepped
+         * concurrently (stepSimulation() waits for the other ones).
+         */
+        unsigned threads;
+        /** Broadphase algorithm of the world. */
+        Broadphase broadphase;
+        /** Lower corner of the world bounds (used by Broadphase::AxisSweep). */
+        Vector3<SI::Length> worldMin;
+        /** Upper corner of the world bounds (used by Broadphase::AxisSweep). */
+        Vector3<SI::Length> worldMax;
+        /**
+         * Maximum number of bodies in the world (used by Broadphase::AxisSweep).
+         *
+         * The sweep & prune broadphase preallocates its handles: Bullet's default
+         * (1.5 million handles) takes about 200 MB per world.
+         */
+        unsigned maxBodies;
+        /** Number of iterations of the constraint solver per step. */
+        unsigned solverIterations;
+        /** Duration of the internal steps (substeps) of the physics engine. */
+        Scalar<SI::Time> fixedTimeStep;
+        /**
+         * Maximum number of substeps in a call to stepSimulation().
+         *
+         * Simulated time requiring more substeps is lost (see getLostTime()).
+         */
+        unsigned maxSubSteps;
+        /** Flag set to solve penetrations separately from the velocities (no energy added by contacts). */
+        bool splitImpulse;
+        /** Number of preallocated contact manifolds (bigger pools avoid heap allocations in crowded scenes). */
+        unsigned manifoldPoolSize;
+        /** Number of preallocated collision algorithms. */
+        unsigned algorithmPoolSize;
+    };
+
+    /** Dynamic state of the bodies & constraints of a world, stored in memory (see makeSnapshot()). */
+    struct SnapshotData {
+        /** States of the bodies (same order as the bodies of the world). */
+        std::vector<btRigidBodyData> bodies;
+        /** States of the constraints, written by Constraint::saveState() (same order as the world). */
+        std::vector<std::string> constraints;
+
+        /**
+         * Writes this state in the snapshot format.
+         *
+         * @param stream Binary output stream.
+         */
+        void write(std::ostream& stream) const;
+
+        /**
+         * Reads a whole snapshot written by write().
+         *
+         * @param stream Binary input stream.
+         * @return The state read from the stream.
+         */
+        static SnapshotData read(std::istream& stream);
+    };
 
     /** Creates a new empty world with default settings. */
     World();
 
+    /**
+     * Creates a new empty world.
+     *
+     * @param[in] settings Construction parameters of the world.
+     */
+    World(const Settings& settings);
+
+    /**
+     * Gets the parameters of this world.
+     *
+     * Includes the changes made after the construction (setFixedTimeStep() & co).
+     *
+     * @return The current settings of this world.
+     */
+    const Settings& getSettings() const {
+        return settings;
+    }
+
+    /**
+     * Sets the duration of the internal steps of the physics engine.
+     * @param value The new duration of a substep (must be positive).
+     */
+    void setFixedTimeStep(Scalar<SI::Time> value);
+
+    /**
+     * Sets the maximum number of substeps in a call to stepSimulation().
+     * @param value The new maximum number of substeps (at least 1).
+     */
+    void setMaxSubSteps(unsigned value);
+
+    /**
+     * Sets the number of iterations of the constraint solver.
+     * @param value The new number of iterations (at least 1).
+     */
+    void setSolverIterations(unsigned value);
+
+    /**
+     * Gets the simulated time lost because stepSimulation() needed more than maxSubSteps substeps.
+     * @return The total simulated time lost by this world.
+     */
+    Scalar<SI::Time> getLostTime() const {
+        return lostTime;
+    }
+
+    /**
+     * Gets the number of calls to stepSimulation() that lost simulated time.
+     * @return The number of clamped steps.
+     */
+    std::uint64_t getClampedSteps() const {
+        return clampedSteps;
+    }
+
     /**
      * Gets the acceleration vector produced by gravity.
      * @return The acceleration vector produced by gravity.
@@ -72,6 +254,8 @@ public:
     /**
      * Adds a new object into the world.
      *
+     * The object is inserted with its collision group & mask (see Body::setCollisionFilter()).
+     *
      * @param object The new object.
      */
     void addObject(std::shared_ptr<Body> object);
@@ -82,6 +266,43 @@ public:
      */
     void addConstraint(std::shared_ptr<Constraint> constraint);
 
+    /**
+     * Removes an object from the world.
+     *
+     * The constraints attached to this object are removed first. Creation listeners
+     * are informed of the deletion. The order of the remaining objects is preserved.
+     *
+     * @param object Object to remove.
+     */
+    void removeObject(Body& object);
+
+    /**
+     * Removes a constraint from the world.
+     *
+     * The order of the remaining constraints is preserved.
+     *
+     * @param constraint Constraint to remove.
+     */
+    void removeConstraint(Constraint& constraint);
+
+    /**
+     * Tests if an object is in this world.
+     *
+     * @param object Object to look for.
+     * @return True if the object is in this world.
+     */
+    bool hasObject(const Body& object) const;
+
+    /**
+     * Tests if a constraint is in this world.
+     *
+     * Constraints are also removed by removeObject() (when removing one of their bodies).
+     *
+     * @param constraint Constraint to look for.
+     * @return True if the constraint is in this world.
+     */
+    bool hasConstraint(const Constraint& constraint) const;
+
     /**
      * Gets the default margin added to collision shapes.
      * @return THe default margin of collision shapes.
@@ -93,10 +314,103 @@ public:
     /**
      * Runs a new step of the simulation.
      *
+     * The step is divided in substeps of Settings::fixedTimeStep. If more than
+     * Settings::maxSubSteps substeps are needed, the remaining time is lost.
+     *
+     * The new transforms of the bodies are published at the end of the step
+     * (see publishTransforms()).
+     *
      * @param[in] timeStep Duration of the step.
      */
     void stepSimulation(double timeStep);
 
+    /**
+     * Gets the time spent in Constraint::beforeTick() during the last call to stepSimulation().
+     *
+     * @return The time spent in the constraint callbacks during the last step.
+     */
+    std::chrono::steady_clock::duration getConstraintsTime() const {
+        return constraintsTime;
+    }
+
+    /**
+     * Gets the time spent in publishTransforms() during the last call to stepSimulation().
+     *
+     * @return The time spent publishing the transforms of the moved bodies during the last step.
+     */
+    std::chrono::steady_clock::duration getPublishTime() const {
+        return publishTime;
+    }
+
+    /**
+     * Publishes a snapshot of the transforms of the moved bodies.
+     *
+     * The snapshot contains every body moved (by the simulation or by a teleport)
+     * since the last snapshot read by the consumer, and the bodies added & removed
+     * since then (see enableBodyEvents()). Nothing is published if nothing changed.
+     *
+     * Must be called only by the thread stepping this world (or while this thread
+     * is paused).
+     */
+    void publishTransforms();
+
+    /**
+     * Gets the latest snapshot of the transforms of the moved bodies.
+     *
+     * Must be called by a single consumer thread. This function never blocks the
+     * thread stepping this world.
+     *
+     * @return The latest snapshot, or nullptr if nothing new was published since the last call.
+     */
+    const TransformBuffer::Snapshot* readTransforms() const;
+
+    /**
+     * Adds the bodies added & removed to the next snapshots of transforms.
+     *
+     * Must be called by the consumer of the snapshots before the world is modified by
+     * another thread. The bodies already in the world are not in the snapshots: the
+     * consumer must read them directly.
+     */
+    void enableBodyEvents() const;
+
+    /**
+     * Saves the dynamic state of all bodies & constraints of this world.
+     *
+     * The snapshot is made of a fixed size header, followed by one btRigidBodyData
+     * record per body (in insertion order), followed by the state of each constraint.
+     *
+     * @param stream Binary output stream.
+     */
+    void saveSnapshot(std::ostream& stream) const;
+
+    /**
+     * Restores a snapshot written by saveSnapshot().
+     *
+     * The world must contain the same bodies & constraints (in the same order) as
+     * the world that wrote the snapshot. The whole snapshot is read & checked before
+     * modifying the world: if it is invalid, the world is left unchanged.
+     *
+     * @param stream Binary input stream.
+     */
+    void loadSnapshot(std::istream& stream);
+
+    /**
+     * Gets the dynamic state of the bodies & constraints of this world.
+     *
+     * @return The current state of this world.
+     */
+    SnapshotData makeSnapshot() const;
+
+    /**
+     * Restores the state of the bodies & constraints of this world.
+     *
+     * Either the whole state is applied, or the world is left unchanged (and an
+     * exception is thrown).
+     *
+     * @param snapshot State of the world, from makeSnapshot() or SnapshotData::read().
+     */
+    void applySnapshot(const SnapshotData& snapshot);
+
     /**
      * Adds a new listener for "new Body" events.
      *
@@ -112,6 +426,12 @@ public:
 
     virtual ~World();
 private:
+    /** Parameters of this world. */
+    Settings settings;
+    /** Broadphase filter of the pairs of bodies (collision groups & Body::disableCollisionsWith()). */
+    class CollisionFilter;
+    /** Broadphase filter of the pairs of bodies (used by broadPhase). */
+    std::unique_ptr<CollisionFilter> collisionFilter;
     /** Broad phase algorithm for collision detection. */
     std::unique_ptr<btBroadphaseInterface> broadPhase;
     /** Narrow phase collision detction configuration. */
@@ -125,12 +445,56 @@ private:
     /** Objects providing callbacks for the bodies in this world.*/
     WorldUpdater worldUpdater;
 
-    /** List of objects in the world. */
-    std::unordered_set<std::shared_ptr<Body>> objects;
-    /** List of constraints between objects of this world. */
-    std::unordered_set<std::shared_ptr<Constraint>> constraints;
-    /** List of objects to inform of new Bodies. */
+    /** List of objects in the world (in insertion order, for deterministic simulations). */
+    std::vector<std::shared_ptr<Body>> objects;
+    /** List of constraints between objects of this world (in insertion order). */
+    std::vector<std::shared_ptr<Constraint>> constraints;
+    /** Handle of each constraint in jointKernel (same order as constraints). */
+    std::vector<std::optional<JointKernel::Handle>> kernelHandles;
+    /** Batched friction & motor computations of the constraints (see Constraint::addToKernel()). */
+    JointKernel jointKernel;
+
+    /** Set of constraints acting on its own set of bodies. */
+    struct ConstraintGroup {
+        /** Constraints of this group not handled by jointKernel (Constraint::beforeTick() is called). */
+        std::vector<Constraint*> callbacks;
+        /** Position of the first joint of this group in jointKernel. */
+        std::size_t kernelBegin;
+        /** Position after the last joint of this group in jointKernel. */
+        std::size_t kernelEnd;
+    };
+
+    /**
+     * Constraints grouped by connected bodies (each group acts on its own set of bodies).
+     *
+     * Each group keeps the insertion order of its constraints. Rebuilt by
+     * updateConstraintGroups() when constraintGroupsValid is false.
+     */
+    std::vector<ConstraintGroup> constraintGroups;
+    /** Bullet parallel task running the constraints of each group. */
+    class ConstraintGroupsTask;
+    /** Flag set when constraintGroups matches constraints. */
+    bool constraintGroupsValid;
+    /** List of objects to inform of new & removed Bodies. */
     mutable std::unordered_set<BodyCreationListener*> createListener;
+    /** Snapshots of the transforms of the bodies, shared with the render thread. */
+    mutable TransformBuffer transforms;
+    /** Bodies moved since the last snapshot known to be read by the consumer (sorted, no duplicates). */
+    std::vector<Body*> unreadBodies;
+    /** Flag set if the bodies added & removed are published (see enableBodyEvents()). */
+    mutable bool bodyEventsEnabled;
+    /** Bodies added & removed since the last published snapshot. */
+    std::vector<TransformBuffer::BodyEvent> newBodyEvents;
+    /** Bodies added & removed in published snapshots not known to be read by the consumer. */
+    std::vector<TransformBuffer::BodyEvent> unreadBodyEvents;
+    /** Time spent in Constraint::beforeTick() during the current (or last) step. */
+    std::chrono::steady_clock::duration constraintsTime;
+    /** Time spent in publishTransforms() during the last step. */
+    std::chrono::steady_clock::duration publishTime;
+    /** Simulated time lost because of the maxSubSteps limit. */
+    Scalar<SI::Time> lostTime;
+    /** Number of calls to stepSimulation() that lost simulated time. */
+    std::uint64_t clampedSteps;
 
     /**
      * Function called before each integration step.
@@ -138,6 +502,16 @@ private:
      */
     void beforeTick(Scalar<BulletUnits::Time> timeStep);
 
+    /** Rebuilds constraintGroups from the current list of constraints. */
+    void updateConstraintGroups();
+
+    /**
+     * Sets the state of the bodies & constraints (no rollback, see applySnapshot()).
+     *
+     * @param snapshot State of the world (with the right number of bodies & constraints).
+     */
+    void loadSnapshotData(const SnapshotData& snapshot);
+
     /**
      * Implementation of Bullet engine callback, called before each step.
      *
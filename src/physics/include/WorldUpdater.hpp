@@ -19,9 +19,20 @@
 #ifndef WORLDUPDATER_HPP
 #define WORLDUPDATER_HPP
 
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
 #include "btBulletDynamicsCommon.h"
 
-/** Interface used by bodies inside a world to update their attributes. */
+class Body;
+
+/**
+ * Interface used by bodies inside a world to update their attributes.
+ *
+ * Teleports can be grouped into batches (see beginBatch()): the broadphase is
+ * then updated once, when the outermost batch ends.
+ */
 class WorldUpdater {
 public:
     /**
@@ -31,9 +42,19 @@ public:
     WorldUpdater(btDiscreteDynamicsWorld& world);
 
     /**
-     * Signal to this object that a new frame will be rendered.
+     * Starts a batch of transform updates.
+     *
+     * Batches can be nested. Each call must be matched by a call to endBatch().
      */
-    void newFrame();
+    void beginBatch();
+
+    /**
+     * Ends a batch of transform updates.
+     *
+     * Ending the outermost batch updates the broadphase, and wakes up the bodies
+     * around the old & new positions of the moved bodies.
+     */
+    void endBatch();
 
     /**
      * Callback used by a Body to update its transform.
@@ -41,11 +62,57 @@ public:
      * @param newTransform The new transform of the specified body.
      */
     void updateTransform(btRigidBody& body, const btTransform& newTransform);
+
+    /**
+     * Forgets a body that is being removed from the world.
+     *
+     * The body is dropped from the current batch & from the dirty list. Bodies
+     * around its old position are still woken up when the batch ends.
+     *
+     * @param body Body removed from the world.
+     */
+    void removeBody(Body& body);
+
+    /**
+     * Callback used by a Body when its transform has changed (simulation or teleport).
+     *
+     * @param body Moved body.
+     */
+    void onBodyMove(Body& body) {
+        dirtyBodies.push_back(&body);
+    }
+
+    /**
+     * Gets the bodies moved since the list was last cleared by its user.
+     *
+     * @return The moved bodies (might contain duplicates).
+     */
+    std::vector<Body*>& getDirtyBodies() {
+        return dirtyBodies;
+    }
 private:
     /** Bullet world updated by this object. */
     btDiscreteDynamicsWorld& world;
-    /** Flag set when all objects in the world have been reactivated. */
-    bool allReactivated;
+    /** Number of batches currently open. */
+    unsigned batchDepth;
+    /** Body moved in the current batch. */
+    struct MovedBody {
+        /** Moved body (null if it was removed from the world during the batch). */
+        btRigidBody* body;
+        /** Minimum corner of the box of the body before the batch. */
+        btVector3 oldAabbMin;
+        /** Maximum corner of the box of the body before the batch. */
+        btVector3 oldAabbMax;
+    };
+
+    /** Bodies moved in the current batch. */
+    std::vector<MovedBody> movedBodies;
+    /** Position of each body of the current batch in movedBodies. */
+    std::unordered_map<const btRigidBody*, std::size_t> movedIndices;
+    /** Bodies moved since the last publication of transforms (see World::publishTransforms()). */
+    std::vector<Body*> dirtyBodies;
+    /** Updates the broadphase & wakes up the neighbours of the moved bodies. */
+    void flush();
 };
 
 #endif /* WORLDUPDATER_HPP */
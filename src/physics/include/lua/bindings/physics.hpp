@@ -1,6 +1,6 @@
 /*
  * This file is part of Insight.
- * Copyright (C) 2018 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
  *
  * Insight is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -16,22 +16,18 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef BODYMOVELISTENER_HPP
-#define BODYMOVELISTENER_HPP
+#ifndef LUA_BINDINGS_PHYSICS_HPP
+#define LUA_BINDINGS_PHYSICS_HPP
 
-#include "btBulletDynamicsCommon.h"
+#include "lua/bindings/LuaDefaultBinding.hpp"
+#include "lua/LuaBinding.hpp"
+#include "lua/types/LuaTable.hpp"
+#include "World.hpp"
 
-/** Interfaces to be informed of a Body movements. */
-class BodyMoveListener {
+template<>
+class LuaBinding<World::Settings> : public LuaDefaultBinding<World::Settings> {
 public:
-    /**
-     * Events triggered when the body has been moved.
-     *
-     * @param[in] transform Object holding the current position & orientation.
-     */
-    virtual void onBodyMove(const btTransform& transform) = 0;
-
-    virtual ~BodyMoveListener() = default;
+    static World::Settings getFromTable(LuaTable& table);
 };
 
-#endif /* BODYMOVELISTENER_HPP */
+#endif /* LUA_BINDINGS_PHYSICS_HPP */
@@ -0,0 +1,94 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file src/physics/physics.cpp
+ * Contains implementations of Lua bindings of the physics engine.
+ */
+
+#include <string>
+
+#include "lua/bindings/bullet.hpp"
+#include "lua/bindings/FundamentalTypes.hpp"
+#include "lua/bindings/physics.hpp"
+#include "lua/helpers/LuaCount.hpp"
+#include "lua/LuaException.hpp"
+#include "lua/types/LuaNativeString.hpp"
+
+/**
+ * Reads an optional positive integer from a Lua table.
+ *
+ * @param table Lua table containing the field.
+ * @param fieldName Name of the field.
+ * @param minValue Minimum value of the field.
+ * @param[in,out] value Value of the field (unchanged if the field is absent).
+ */
+static void getOptionalCount(LuaTable& table, const char* fieldName, unsigned minValue, unsigned& value) {
+    if (table.has<LuaNativeString>(fieldName)) {
+        double newValue = table.get<LuaNativeString, double>(fieldName);
+        if (!isLuaCount<unsigned>(newValue, minValue)) {
+            std::string msg = std::string("World settings: '") + fieldName + "' must be an integer, at least " + std::to_string(minValue) + ".";
+            throw LuaException(msg.c_str());
+        }
+        value = static_cast<unsigned>(newValue);
+    }
+}
+
+World::Settings LuaBinding<World::Settings>::getFromTable(LuaTable& table) {
+    using Str = LuaNativeString;
+    using Broadphase = World::Settings::Broadphase;
+    World::Settings result;
+    getOptionalCount(table, "threads", 1, result.threads);
+    if (table.has<Str>("broadphase")) {
+        std::string broadphase = table.get<Str, Str>("broadphase");
+        if (broadphase == "dbvt") {
+            result.broadphase = Broadphase::Dbvt;
+        } else if (broadphase == "axisSweep") {
+            result.broadphase = Broadphase::AxisSweep;
+        } else {
+            std::string msg = std::string("World settings: invalid 'broadphase' (expected 'dbvt' or 'axisSweep'): ") + broadphase;
+            throw LuaException(msg.c_str());
+        }
+    }
+    if (table.has<Str>("worldMin")) {
+        result.worldMin = table.get<Str, Vector3<SI::Length>>("worldMin");
+    }
+    if (table.has<Str>("worldMax")) {
+        result.worldMax = table.get<Str, Vector3<SI::Length>>("worldMax");
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        if (result.worldMin.value[axis] >= result.worldMax.value[axis]) {
+            throw LuaException("World settings: 'worldMin' must be lower than 'worldMax' on each axis.");
+        }
+    }
+    getOptionalCount(table, "maxBodies", 1, result.maxBodies);
+    getOptionalCount(table, "solverIterations", 1, result.solverIterations);
+    if (table.has<Str>("fixedTimeStep")) {
+        result.fixedTimeStep = table.get<Str, Scalar<SI::Time>>("fixedTimeStep");
+        if (!(result.fixedTimeStep.value > 0)) {
+            throw LuaException("World settings: 'fixedTimeStep' must be positive.");
+        }
+    }
+    getOptionalCount(table, "maxSubSteps", 1, result.maxSubSteps);
+    if (table.has<Str>("splitImpulse")) {
+        result.splitImpulse = table.get<Str, bool>("splitImpulse");
+    }
+    getOptionalCount(table, "manifoldPoolSize", 1, result.manifoldPoolSize);
+    getOptionalCount(table, "algorithmPoolSize", 1, result.algorithmPoolSize);
+    return result;
+}
@@ -0,0 +1,279 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <catch.hpp>
+
+#include "btBulletDynamicsCommon.h"
+
+#include "ConvexMesh.hpp"
+
+namespace {
+    /** Tolerance of the geometric tests (input points have coordinates around 1). */
+    const btScalar TOLERANCE = btScalar(1e-4);
+
+    /**
+     * Generates random points in a box.
+     * @param count Number of points.
+     * @param halfExtents Half extents of the box (centered on the origin).
+     * @param seed Seed of the random generator.
+     * @return The generated points.
+     */
+    std::vector<btVector3> randomPoints(std::size_t count, const btVector3& halfExtents, unsigned seed) {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<btScalar> distribution(-1, 1);
+        std::vector<btVector3> result;
+        for (std::size_t i = 0; i < count; i++) {
+            btScalar x = distribution(generator);
+            btScalar y = distribution(generator);
+            btScalar z = distribution(generator);
+            result.push_back(btVector3(x * halfExtents.x(), y * halfExtents.y(), z * halfExtents.z()));
+        }
+        return result;
+    }
+
+    /**
+     * Generates points evenly distributed on a sphere (Fibonacci lattice).
+     * @param count Number of points.
+     * @param radius Radius of the sphere.
+     * @return The generated points.
+     */
+    std::vector<btVector3> spherePoints(std::size_t count, btScalar radius) {
+        const double GOLDEN_ANGLE = M_PI * (3 - std::sqrt(5.0));
+        std::vector<btVector3> result;
+        for (std::size_t i = 0; i < count; i++) {
+            double y = 1 - 2 * (i + 0.5) / count;
+            double r = std::sqrt(1 - y*y);
+            double theta = GOLDEN_ANGLE * i;
+            result.push_back(radius * btVector3(btScalar(r * std::cos(theta)), btScalar(y), btScalar(r * std::sin(theta))));
+        }
+        return result;
+    }
+
+    /**
+     * Computes the distance between a point and a triangle.
+     * @param p Point to evaluate.
+     * @param a First vertex of the triangle.
+     * @param b Second vertex of the triangle.
+     * @param c Third vertex of the triangle.
+     * @return The distance between the point and the closest point of the triangle.
+     */
+    btScalar triangleDistance(const btVector3& p, const btVector3& a, const btVector3& b, const btVector3& c) {
+        // Closest point on each edge, or the projection inside the triangle.
+        auto segmentDistance = [&p](const btVector3& u, const btVector3& v) -> btScalar {
+            btVector3 uv = v - u;
+            btScalar t = std::min(btScalar(1), std::max(btScalar(0), (p - u).dot(uv) / uv.length2()));
+            return (p - (u + t * uv)).length();
+        };
+        btScalar result = std::min(segmentDistance(a, b), std::min(segmentDistance(b, c), segmentDistance(c, a)));
+        btVector3 normal = (b - a).cross(c - a).normalized();
+        btVector3 projection = p - normal.dot(p - a) * normal;
+        bool inside = (b - a).cross(projection - a).dot(normal) >= 0 &&
+                      (c - b).cross(projection - b).dot(normal) >= 0 &&
+                      (a - c).cross(projection - c).dot(normal) >= 0;
+        if (inside) {
+            result = std::min(result, btFabs(normal.dot(p - a)));
+        }
+        return result;
+    }
+
+    /**
+     * Computes the distance between a point and a convex mesh.
+     * @param point Point to evaluate.
+     * @param mesh Convex mesh.
+     * @return 0 if the point is inside the mesh, its distance to the surface otherwise.
+     */
+    btScalar meshDistance(const btVector3& point, const ConvexMesh& mesh) {
+        const std::vector<btVector3>& vertices = mesh.getVertices();
+        const std::vector<unsigned>& indices = mesh.getIndices();
+        bool inside = true;
+        btScalar result = std::numeric_limits<btScalar>::infinity();
+        for (std::size_t triangle = 0; triangle < mesh.getTriangleCount(); triangle++) {
+            const btVector3& a = vertices[indices[3*triangle]];
+            const btVector3& b = vertices[indices[3*triangle+1]];
+            const btVector3& c = vertices[indices[3*triangle+2]];
+            inside = inside && (mesh.getNormals()[triangle].dot(point - a) <= 0);
+            result = std::min(result, triangleDistance(point, a, b, c));
+        }
+        return inside ? 0 : result;
+    }
+
+    /**
+     * Checks that a mesh is a closed convex manifold, with CCW triangles & outward normals.
+     * @param mesh Mesh to check.
+     */
+    void checkMesh(const ConvexMesh& mesh) {
+        const std::vector<btVector3>& vertices = mesh.getVertices();
+        const std::vector<unsigned>& indices = mesh.getIndices();
+        const std::vector<btVector3>& normals = mesh.getNormals();
+        REQUIRE(indices.size() == 3 * mesh.getTriangleCount());
+        REQUIRE(normals.size() == mesh.getTriangleCount());
+        // Each directed edge must be used once, and its reverse once (by another triangle).
+        std::map<std::pair<unsigned,unsigned>,int> edgeCount;
+        std::vector<bool> usedVertices(vertices.size(), false);
+        bool validIndices = true;
+        bool validNormals = true;
+        btScalar maxVertexDistance = 0;
+        for (std::size_t triangle = 0; triangle < mesh.getTriangleCount(); triangle++) {
+            for (std::size_t k = 0; k < 3; k++) {
+                unsigned from = indices[3*triangle + k];
+                unsigned to = indices[3*triangle + (k+1)%3];
+                validIndices = validIndices && (from < vertices.size()) && (from != to);
+                edgeCount[std::make_pair(from, to)]++;
+                usedVertices[from] = true;
+            }
+            const btVector3& a = vertices[indices[3*triangle]];
+            const btVector3& b = vertices[indices[3*triangle+1]];
+            const btVector3& c = vertices[indices[3*triangle+2]];
+            // CCW seen from outside: the geometric normal agrees with the stored normal.
+            const btVector3& normal = normals[triangle];
+            validNormals = validNormals && (std::fabs(normal.length() - 1) <= TOLERANCE);
+            validNormals = validNormals && ((b - a).cross(c - a).dot(normal) > 0);
+            // Outward: no vertex in front of the triangle.
+            for (const btVector3& vertex : vertices) {
+                maxVertexDistance = std::max(maxVertexDistance, normal.dot(vertex - a));
+            }
+        }
+        REQUIRE(validIndices);
+        REQUIRE(validNormals);
+        REQUIRE(maxVertexDistance <= TOLERANCE);
+        bool manifold = true;
+        for (const auto& edge : edgeCount) {
+            auto reverse = edgeCount.find(std::make_pair(edge.first.second, edge.first.first));
+            manifold = manifold && (edge.second == 1) && (reverse != edgeCount.end());
+        }
+        REQUIRE(manifold);
+        REQUIRE(std::find(usedVertices.begin(), usedVertices.end(), false) == usedVertices.end());
+        // Euler characteristic of a sphere: V - E + F = 2.
+        std::size_t edges = edgeCount.size() / 2;
+        REQUIRE(vertices.size() + mesh.getTriangleCount() == edges + 2);
+    }
+
+    /**
+     * Checks that no input point is farther than the error of the mesh.
+     * @param points Input points of the mesh.
+     * @param mesh Mesh built from points.
+     */
+    void checkError(const std::vector<btVector3>& points, const ConvexMesh& mesh) {
+        btScalar maxDistance = 0;
+        for (const btVector3& point : points) {
+            maxDistance = std::max(maxDistance, meshDistance(point, mesh));
+        }
+        REQUIRE(maxDistance <= mesh.getError() + TOLERANCE);
+    }
+}
+
+TEST_CASE("ConvexMesh") {
+    SECTION("Cube with interior points") {
+        std::vector<btVector3> points = randomPoints(200, btVector3(0.9, 0.9, 0.9), 7);
+        for (int corner = 0; corner < 8; corner++) {
+            btScalar x = (corner & 1) ? 1 : -1;
+            btScalar y = (corner & 2) ? 1 : -1;
+            btScalar z = (corner & 4) ? 1 : -1;
+            points.push_back(btVector3(x, y, z));
+        }
+        ConvexMesh mesh(points);
+        REQUIRE(mesh.getVertices().size() == 8);
+        REQUIRE(mesh.getTriangleCount() == 12);
+        REQUIRE(mesh.getError() == 0);
+        checkMesh(mesh);
+        checkError(points, mesh);
+    }
+
+    SECTION("Random points") {
+        std::vector<btVector3> points = randomPoints(1000, btVector3(1, 2, 3), 42);
+        ConvexMesh mesh(points);
+        checkMesh(mesh);
+        checkError(points, mesh);
+        // Every vertex of the mesh is an input point.
+        bool inputVertices = true;
+        for (const btVector3& vertex : mesh.getVertices()) {
+            inputVertices = inputVertices && std::find_if(points.begin(), points.end(), [&vertex](const btVector3& point) -> bool {
+                return (point - vertex).length2() == 0;
+            }) != points.end();
+        }
+        REQUIRE(inputVertices);
+    }
+
+    SECTION("Degenerate inputs") {
+        std::vector<btVector3> tooFew = {btVector3(0,0,0), btVector3(1,0,0), btVector3(0,1,0)};
+        REQUIRE_THROWS_AS(ConvexMesh{tooFew}, std::invalid_argument);
+        std::vector<btVector3> identical(5, btVector3(1, 2, 3));
+        REQUIRE_THROWS_AS(ConvexMesh{identical}, std::invalid_argument);
+        std::vector<btVector3> colinear;
+        for (int i = 0; i < 6; i++) {
+            colinear.push_back(btVector3(1, 2, 3) + btScalar(i) * btVector3(1, -1, 2));
+        }
+        REQUIRE_THROWS_AS(ConvexMesh{colinear}, std::invalid_argument);
+        std::vector<btVector3> coplanar;
+        for (int i = 0; i < 5; i++) {
+            for (int j = 0; j < 5; j++) {
+                coplanar.push_back(btScalar(i) * btVector3(1, 1, 0) + btScalar(j) * btVector3(0, 1, 1));
+            }
+        }
+        REQUIRE_THROWS_AS(ConvexMesh{coplanar}, std::invalid_argument);
+        std::vector<btVector3> points = randomPoints(10, btVector3(1, 1, 1), 3);
+        REQUIRE_THROWS_AS((ConvexMesh{points, 3}), std::invalid_argument);
+    }
+
+    SECTION("Vertex budget") {
+        std::vector<btVector3> points = randomPoints(2000, btVector3(1, 2, 3), 5);
+        for (std::size_t maxVertices : {4, 8, 16, 32}) {
+            ConvexMesh mesh(points, maxVertices);
+            REQUIRE(mesh.getVertices().size() <= maxVertices);
+            REQUIRE(mesh.getError() > 0);
+            checkMesh(mesh);
+            checkError(points, mesh);
+        }
+    }
+
+    SECTION("Dense points on a sphere") {
+        std::vector<btVector3> points = spherePoints(5000, 1);
+        ConvexMesh mesh(points);
+        checkMesh(mesh);
+        checkError(points, mesh);
+    }
+
+    SECTION("Nearly coplanar points") {
+        // Thin slab: a dense grid with tiny noise on its top face.
+        std::mt19937 generator(11);
+        std::uniform_real_distribution<btScalar> noise(btScalar(-1e-6), btScalar(1e-6));
+        std::vector<btVector3> points;
+        const int GRID_SIZE = 40;
+        for (int i = 0; i < GRID_SIZE; i++) {
+            for (int j = 0; j < GRID_SIZE; j++) {
+                btScalar x = btScalar(i) / (GRID_SIZE - 1);
+                btScalar z = btScalar(j) / (GRID_SIZE - 1);
+                points.push_back(btVector3(x, noise(generator), z));
+            }
+        }
+        points.push_back(btVector3(0.5, -0.1, 0.5));
+        ConvexMesh mesh(points);
+        checkMesh(mesh);
+        checkError(points, mesh);
+    }
+}
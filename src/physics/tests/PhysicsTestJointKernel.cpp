@@ -0,0 +1,321 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch.hpp>
+
+#include "btBulletDynamicsCommon.h"
+
+#include "JointKernel.hpp"
+
+namespace {
+    /** Duration of an integration step (s). */
+    const btScalar TIME_STEP = btScalar(1) / 240;
+
+    /**
+     * Joint computing its friction & motor torques on its own (formulas of the joints before JointKernel).
+     *
+     * Used as a reference for the results of JointKernel.
+     */
+    struct ReferenceJoint {
+        /** Body holding the convex part of the joint. */
+        btRigidBody* convexBody;
+        /** Body holding the concave part of the joint. */
+        btRigidBody* concaveBody;
+        /** Orientation of the joint frame, relative to the convex body. */
+        btMatrix3x3 jointBasis;
+        /** Friction coefficient around each axis of the joint frame. */
+        btVector3 frictionCoefficients;
+        /** Axes of the joint frame handled by this joint (1: handled, 0: ignored). */
+        btVector3 axes;
+        /** Motor torque (joint frame). */
+        btVector3 motorTorque;
+
+        /**
+         * Applies the friction & motor torques of this joint.
+         * @param timeStep Duration of the next integration step.
+         */
+        void beforeTick(btScalar timeStep) {
+            btMatrix3x3 basis = convexBody->getWorldTransform().getBasis() * jointBasis;
+            // Friction
+            btVector3 relativeVelocity = concaveBody->getAngularVelocity() - convexBody->getAngularVelocity();
+            btVector3 refVelocity = basis.inverse() * relativeVelocity;
+            btVector3 refFriction = refVelocity * frictionCoefficients * axes;
+            auto computeImpulse = [this,timeStep](const btRigidBody& body, const btVector3& torque) -> btVector3 {
+                return axes * (jointBasis.transpose().scaled(body.getInvInertiaDiagLocal()) * (jointBasis * torque * timeStep));
+            };
+            btVector3 convexImpulse = computeImpulse(*convexBody, refFriction);
+            btVector3 concaveImpulse = computeImpulse(*concaveBody, -refFriction);
+            btVector3 newRefVelocity = refVelocity + concaveImpulse - convexImpulse;
+            for (int i = 0; i < 3; i++) {
+                btScalar prevVel = refVelocity[i];
+                btScalar newVel = newRefVelocity[i];
+                if (newVel * prevVel < 0) {
+                    btScalar factor = std::fabs(prevVel / (prevVel - newVel));
+                    convexImpulse[i] *= factor;
+                    concaveImpulse[i] *= factor;
+                }
+            }
+            convexBody->setAngularVelocity(convexBody->getAngularVelocity() + basis * convexImpulse);
+            concaveBody->setAngularVelocity(concaveBody->getAngularVelocity() + basis * concaveImpulse);
+            // Motor
+            btVector3 absMotorTorque = basis * (motorTorque * axes);
+            convexBody->applyTorque(absMotorTorque);
+            concaveBody->applyTorque(-absMotorTorque);
+        }
+    };
+
+    /**
+     * Chain of bodies linked by joints, with random orientations, velocities & joint parameters.
+     *
+     * Two scenes built with the same arguments are identical.
+     */
+    class TestScene {
+    public:
+        /**
+         * Creates a new scene.
+         * @param nbBodies Number of bodies in the chain.
+         * @param seed Seed of the random generator.
+         */
+        TestScene(std::size_t nbBodies, unsigned seed) :
+            shape(btVector3(btScalar(0.1), btScalar(0.2), btScalar(0.3)))
+        {
+            std::mt19937 generator(seed);
+            std::uniform_real_distribution<btScalar> distribution(-1, 1);
+            auto randomRotation = [&generator, &distribution]() -> btQuaternion {
+                return btQuaternion(SIMD_PI * distribution(generator), SIMD_PI * distribution(generator), SIMD_PI * distribution(generator));
+            };
+            auto randomVector = [&generator, &distribution](btScalar scale) -> btVector3 {
+                return scale * btVector3(distribution(generator), distribution(generator), distribution(generator));
+            };
+            for (std::size_t i = 0; i < nbBodies; i++) {
+                btScalar mass = 1 + i % 3;
+                btVector3 inertia;
+                shape.calculateLocalInertia(mass, inertia);
+                btRigidBody::btRigidBodyConstructionInfo info(mass, nullptr, &shape, inertia);
+                info.m_startWorldTransform.setRotation(randomRotation());
+                bodies.push_back(std::make_unique<btRigidBody>(info));
+                bodies.back()->setAngularVelocity(randomVector(5));
+            }
+            for (std::size_t i = 1; i < nbBodies; i++) {
+                // Alternate hinges & ball joints.
+                btVector3 axes = (i % 2 == 0) ? btVector3(1,1,1) : btVector3(1,0,0);
+                btVector3 friction = randomVector(1).absolute();
+                joints.push_back({bodies[i-1].get(), bodies[i].get(), btMatrix3x3(randomRotation()), friction, axes, randomVector(2)});
+            }
+        }
+
+        /**
+         * Adds a joint of this scene into a kernel.
+         * @param kernel Kernel receiving the joint.
+         * @param[in] joint Joint to add.
+         * @return The handle of the joint in the kernel.
+         */
+        static JointKernel::Handle addJoint(JointKernel& kernel, const ReferenceJoint& joint) {
+            JointKernel::Handle handle = kernel.add(*joint.convexBody, *joint.concaveBody, joint.jointBasis,
+                                                    joint.frictionCoefficients, joint.axes);
+            kernel.setMotorTorque(handle, joint.motorTorque * joint.axes);
+            return handle;
+        }
+
+        /**
+         * Adds the joints of this scene into a kernel.
+         * @param kernel Kernel receiving the joints.
+         * @return The handle of each joint (same order as joints).
+         */
+        std::vector<JointKernel::Handle> addJoints(JointKernel& kernel) {
+            std::vector<JointKernel::Handle> result;
+            for (const ReferenceJoint& joint : joints) {
+                result.push_back(addJoint(kernel, joint));
+            }
+            return result;
+        }
+
+        /** Runs the per-joint computations (in insertion order). */
+        void runReference() {
+            for (ReferenceJoint& joint : joints) {
+                joint.beforeTick(TIME_STEP);
+            }
+        }
+
+        /**
+         * Changes the mass (and inertia) of a body.
+         * @param index Index of the body.
+         * @param mass New mass of the body.
+         */
+        void setMass(std::size_t index, btScalar mass) {
+            btVector3 inertia;
+            shape.calculateLocalInertia(mass, inertia);
+            bodies[index]->setMassProps(mass, inertia);
+            bodies[index]->updateInertiaTensor();
+        }
+
+        /** Shape of all the bodies. */
+        btBoxShape shape;
+        /** Bodies of the chain. */
+        std::vector<std::unique_ptr<btRigidBody>> bodies;
+        /** Joints between consecutive bodies. */
+        std::vector<ReferenceJoint> joints;
+    };
+
+    /**
+     * Tests if two vectors are equal, within a tolerance relative to their magnitude.
+     * @param a First vector.
+     * @param b Second vector.
+     * @return True if the vectors are close.
+     */
+    bool isClose(const btVector3& a, const btVector3& b) {
+        const btScalar TOLERANCE = btScalar(1e-4);
+        return (a - b).length() <= TOLERANCE * (1 + b.length());
+    }
+
+    /**
+     * Tests if the bodies of two scenes have the same angular velocities & torques.
+     * @param kernelScene Scene updated by a JointKernel.
+     * @param referenceScene Scene updated by the per-joint computations.
+     * @return True if the states are close.
+     */
+    bool isClose(const TestScene& kernelScene, const TestScene& referenceScene) {
+        bool result = true;
+        for (std::size_t i = 0; i < kernelScene.bodies.size(); i++) {
+            const btRigidBody& kernelBody = *kernelScene.bodies[i];
+            const btRigidBody& referenceBody = *referenceScene.bodies[i];
+            result = result && isClose(kernelBody.getAngularVelocity(), referenceBody.getAngularVelocity());
+            result = result && isClose(kernelBody.getTotalTorque(), referenceBody.getTotalTorque());
+        }
+        return result;
+    }
+}
+
+TEST_CASE("JointKernel") {
+    const std::size_t NB_BODIES = 16;
+    TestScene kernelScene(NB_BODIES, 42);
+    TestScene referenceScene(NB_BODIES, 42);
+    JointKernel kernel;
+    kernelScene.addJoints(kernel);
+    REQUIRE(kernel.size() == NB_BODIES - 1);
+
+    SECTION("run (same results as the per-joint computations)") {
+        for (int tick = 0; tick < 10; tick++) {
+            kernel.run(0, kernel.size(), TIME_STEP);
+            referenceScene.runReference();
+            REQUIRE(isClose(kernelScene, referenceScene));
+        }
+    }
+
+    SECTION("run (after a change of inertia)") {
+        kernel.run(0, kernel.size(), TIME_STEP);
+        referenceScene.runReference();
+        kernelScene.setMass(3, 10);
+        referenceScene.setMass(3, 10);
+        kernel.run(0, kernel.size(), TIME_STEP);
+        referenceScene.runReference();
+        REQUIRE(isClose(kernelScene, referenceScene));
+    }
+}
+
+TEST_CASE("JointKernel: remove & add") {
+    const std::size_t NB_BODIES = 16;
+    TestScene kernelScene(NB_BODIES, 42);
+    TestScene referenceScene(NB_BODIES, 42);
+    JointKernel kernel;
+    // Handle of each joint of referenceScene.joints (same order as the kernel).
+    std::vector<JointKernel::Handle> handles = kernelScene.addJoints(kernel);
+
+    // Removes joints from the middle (highest index first: lower indices stay valid).
+    const std::vector<std::size_t> REMOVED = {9, 4, 3};
+    // Removed joints of kernelScene (kernelScene.joints is left unchanged) & referenceScene.
+    std::vector<ReferenceJoint> removedKernelJoints;
+    std::vector<ReferenceJoint> removedReferenceJoints;
+    std::vector<JointKernel::Handle> freedHandles;
+    for (std::size_t index : REMOVED) {
+        kernel.remove(handles[index]);
+        freedHandles.push_back(handles[index]);
+        handles.erase(handles.begin() + index);
+        removedKernelJoints.push_back(kernelScene.joints[index]);
+        removedReferenceJoints.push_back(referenceScene.joints[index]);
+        referenceScene.joints.erase(referenceScene.joints.begin() + index);
+    }
+    REQUIRE(kernel.size() == NB_BODIES - 1 - REMOVED.size());
+
+    SECTION("run (after remove)") {
+        for (int tick = 0; tick < 10; tick++) {
+            kernel.run(0, kernel.size(), TIME_STEP);
+            referenceScene.runReference();
+            REQUIRE(isClose(kernelScene, referenceScene));
+        }
+    }
+
+    SECTION("run (after remove & add)") {
+        // Joints added again are appended, and reuse the freed handles.
+        for (std::size_t index = 0; index < REMOVED.size(); index++) {
+            JointKernel::Handle handle = TestScene::addJoint(kernel, removedKernelJoints[index]);
+            REQUIRE(std::find(freedHandles.begin(), freedHandles.end(), handle) != freedHandles.end());
+            REQUIRE(std::find(handles.begin(), handles.end(), handle) == handles.end());
+            handles.push_back(handle);
+            referenceScene.joints.push_back(removedReferenceJoints[index]);
+        }
+        REQUIRE(kernel.size() == NB_BODIES - 1);
+        // Each handle must still address its own joint.
+        for (std::size_t index = 0; index < handles.size(); index++) {
+            ReferenceJoint& joint = referenceScene.joints[index];
+            joint.motorTorque = btVector3(btScalar(index), 1, -btScalar(index));
+            kernel.setMotorTorque(handles[index], joint.motorTorque * joint.axes);
+        }
+        for (int tick = 0; tick < 10; tick++) {
+            kernel.run(0, kernel.size(), TIME_STEP);
+            referenceScene.runReference();
+            REQUIRE(isClose(kernelScene, referenceScene));
+        }
+    }
+}
+
+TEST_CASE("JointKernel timing", "[.][timing]") {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    const std::size_t NB_BODIES = 10000;
+    const int NB_TICKS = 100;
+    TestScene kernelScene(NB_BODIES, 42);
+    TestScene referenceScene(NB_BODIES, 42);
+    JointKernel kernel;
+    kernelScene.addJoints(kernel);
+
+    Clock::time_point start = Clock::now();
+    for (int tick = 0; tick < NB_TICKS; tick++) {
+        referenceScene.runReference();
+    }
+    Milliseconds referenceTime = Clock::now() - start;
+
+    start = Clock::now();
+    for (int tick = 0; tick < NB_TICKS; tick++) {
+        kernel.run(0, kernel.size(), TIME_STEP);
+    }
+    Milliseconds kernelTime = Clock::now() - start;
+
+    std::cout << "JointKernel: " << kernel.size() << " joints, " << NB_TICKS << " ticks. Per-joint code: ";
+    std::cout << referenceTime.count() << " ms, kernel: " << kernelTime.count() << " ms." << std::endl;
+    REQUIRE(isClose(kernelScene, referenceScene));
+}
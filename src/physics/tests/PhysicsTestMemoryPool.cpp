@@ -0,0 +1,79 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <memory>
+
+#include <catch.hpp>
+
+#include "MemoryPool.hpp"
+
+namespace {
+    /** Object allocated by makePooled() in these tests. */
+    struct PooledObject {
+        PooledObject(int value) : value(value) {
+
+        }
+
+        int value;
+    };
+}
+
+TEST_CASE("MemoryPool") {
+    MemoryPool pool;
+    const std::size_t SIZE = 48;
+
+    void* block = pool.allocate(SIZE);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(block) % MemoryPool::ALIGNMENT == 0);
+    REQUIRE(pool.getFreeCount() == 0);
+
+    pool.deallocate(block, SIZE);
+    REQUIRE(pool.getFreeCount() == 1);
+
+    SECTION("allocate (same size, recycled)") {
+        void* recycled = pool.allocate(SIZE);
+        REQUIRE(recycled == block);
+        REQUIRE(pool.getFreeCount() == 0);
+        pool.deallocate(recycled, SIZE);
+    }
+
+    SECTION("allocate (other size, not recycled)") {
+        void* other = pool.allocate(2 * SIZE);
+        REQUIRE(other != block);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(other) % MemoryPool::ALIGNMENT == 0);
+        REQUIRE(pool.getFreeCount() == 1);
+        pool.deallocate(other, 2 * SIZE);
+        REQUIRE(pool.getFreeCount() == 2);
+    }
+}
+
+TEST_CASE("makePooled") {
+    MemoryPool& pool = MemoryPool::global();
+    std::shared_ptr<PooledObject> object = makePooled<PooledObject>(5);
+    REQUIRE(object->value == 5);
+    const void* address = object.get();
+
+    std::size_t freeCount = pool.getFreeCount();
+    object.reset();
+    REQUIRE(pool.getFreeCount() == freeCount + 1);
+
+    object = makePooled<PooledObject>(7);
+    REQUIRE(object.get() == address);
+    REQUIRE(object->value == 7);
+    REQUIRE(pool.getFreeCount() == freeCount);
+}
@@ -0,0 +1,114 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+
+#include <catch.hpp>
+
+#include "Body.hpp"
+#include "SphereShape.hpp"
+#include "TransformBuffer.hpp"
+#include "units/Scalar.hpp"
+#include "units/SI.hpp"
+#include "World.hpp"
+
+/** Creates a new sphere body. */
+static std::shared_ptr<Body> newBody() {
+    return std::make_shared<Body>(SphereShape::makeShared(Scalar<SI::Mass>(1), Scalar<SI::Length>(0.5)));
+}
+
+/** Tests if a snapshot holds the transform of a body. */
+static bool hasTransform(const TransformBuffer::Snapshot& snapshot, const Body& body) {
+    for (const auto& entry : snapshot.transforms) {
+        if (entry.body == &body) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST_CASE("World: bodies added & removed in the snapshots of transforms") {
+    World world;
+    world.enableBodyEvents();
+    auto first = newBody();
+    world.addObject(first);
+    world.publishTransforms();
+    const TransformBuffer::Snapshot* snapshot = world.readTransforms();
+    REQUIRE(snapshot != nullptr);
+    REQUIRE(snapshot->events.size() == 1);
+    REQUIRE(snapshot->events[0].body == first.get());
+    REQUIRE(snapshot->events[0].shape.get() == &first->getShape());
+    REQUIRE(hasTransform(*snapshot, *first));
+    REQUIRE(world.readTransforms() == nullptr);
+
+    SECTION("Removed body") {
+        world.removeObject(*first);
+        world.publishTransforms();
+        snapshot = world.readTransforms();
+        REQUIRE(snapshot != nullptr);
+        REQUIRE(snapshot->events.size() == 1);
+        REQUIRE(snapshot->events[0].body == first.get());
+        REQUIRE(snapshot->events[0].shape == nullptr);
+        REQUIRE(snapshot->transforms.empty());
+    }
+
+    SECTION("Body added & removed between two snapshots") {
+        auto second = newBody();
+        world.addObject(second);
+        world.removeObject(*second);
+        world.publishTransforms();
+        snapshot = world.readTransforms();
+        if (snapshot != nullptr) {
+            REQUIRE(snapshot->events.empty());
+            REQUIRE_FALSE(hasTransform(*snapshot, *second));
+        }
+    }
+
+    SECTION("Events of an unread snapshot") {
+        auto second = newBody();
+        world.addObject(second);
+        world.publishTransforms();
+        world.removeObject(*first);
+        auto third = newBody();
+        world.addObject(third);
+        world.publishTransforms();
+        snapshot = world.readTransforms();
+        REQUIRE(snapshot != nullptr);
+        REQUIRE(snapshot->events.size() == 3);
+        REQUIRE(snapshot->events[0].body == second.get());
+        REQUIRE(snapshot->events[0].shape != nullptr);
+        REQUIRE(snapshot->events[1].body == first.get());
+        REQUIRE(snapshot->events[1].shape == nullptr);
+        REQUIRE(snapshot->events[2].body == third.get());
+        REQUIRE(snapshot->events[2].shape != nullptr);
+        REQUIRE(hasTransform(*snapshot, *second));
+        REQUIRE(hasTransform(*snapshot, *third));
+        REQUIRE_FALSE(hasTransform(*snapshot, *first));
+    }
+}
+
+TEST_CASE("World: no body events unless enabled") {
+    World world;
+    auto body = newBody();
+    world.addObject(body);
+    world.publishTransforms();
+    const TransformBuffer::Snapshot* snapshot = world.readTransforms();
+    REQUIRE(snapshot != nullptr);
+    REQUIRE(snapshot->events.empty());
+    REQUIRE(hasTransform(*snapshot, *body));
+}
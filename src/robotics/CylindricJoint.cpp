@@ -18,8 +18,8 @@
 
 #include <algorithm>
 
+#include "BinaryStream.hpp"
 #include "CylindricJoint.hpp"
-#include "units/Matrix3x3.hpp"
 
 /** Axis of the hinge, in the joint frame. */
 static const btVector3 HINGE_AXIS(1,0,0);
@@ -67,7 +67,10 @@ CylindricJoint::CylindricJoint(Body& cylinder, Body& socket, const CylindricJoin
     constraint(makeConstraint(cylinder, socket, info)),
     rotationSense([this]() -> float { return this->getRotation().value; }),
     motorTorque(0),
-    motorAction([this](const float& value) { this->setMotorTorque(Scalar<SI::Torque>(value)); })
+    motorAction(
+        [this](const float& value) { this->setMotorTorque(Scalar<SI::Torque>(value)); },
+        [this]() { this->wakeUp(); }
+    )
 {
     if (placeCylinder) {
         initPosition(socket, info.concaveTransform, cylinder, info.convexTransform, info.startRotation);
@@ -78,37 +81,30 @@ CylindricJoint::CylindricJoint(Body& cylinder, Body& socket, const CylindricJoin
 
 CylindricJoint::~CylindricJoint() = default;
 
-void CylindricJoint::applyFriction(const Scalar<BulletUnits::Time> timeStep, const btMatrix3x3& convexBasis) {
-    Vector3<SI::AngularVelocity> relativeVelocity = concavePart.getAngularVelocity() - convexPart.getAngularVelocity();
-    Scalar<SI::AngularVelocity> refVelocity = (convexBasis.inverse() * relativeVelocity).dot(HINGE_AXIS);
-    Scalar<SI::Torque> refFriction = refVelocity * jointInfo.frictionCoefficient;
-    auto computeImpulse = [this,timeStep](const Body& body, const Scalar<SI::Torque>& torque) -> Scalar<SI::AngularVelocity> {
-        const auto& basis = this->jointInfo.convexTransform.getBasis();
-        Vector3<SI::Torque> vTorque = torque * HINGE_AXIS;
-        auto vecImpulse = Matrix3x3<SI::NoUnit>(basis.transpose()).scaled(body.getInvInertiaDiagLocal()) * (basis * vTorque * timeStep * Scalar<SI::Angle>(1));
-        return vecImpulse.dot(HINGE_AXIS);
-    };
-    Scalar<SI::AngularVelocity> convexImpulse = computeImpulse(convexPart, refFriction);
-    Scalar<SI::AngularVelocity> concaveImpulse = computeImpulse(concavePart, -refFriction);
-    Scalar<SI::AngularVelocity> newRefVelocity = refVelocity + concaveImpulse - convexImpulse;
-    if (newRefVelocity.value * refVelocity.value < 0) {
-        float factor = fabs(refVelocity.value / (refVelocity.value - newRefVelocity.value));
-        convexImpulse *= factor;
-        concaveImpulse *= factor;
+std::optional<JointKernel::Handle> CylindricJoint::addToKernel(JointKernel& newKernel) {
+    btVector3 friction = toBulletUnits(jointInfo.frictionCoefficient) * HINGE_AXIS;
+    kernelHandle = newKernel.add(convexPart.getBulletBody(), concavePart.getBulletBody(),
+                                 jointInfo.convexTransform.getBasis(), friction, HINGE_AXIS);
+    kernel = &newKernel;
+    updateKernelTorque();
+    return kernelHandle;
+}
+
+void CylindricJoint::updateKernelTorque() {
+    if (kernel != nullptr) {
+        kernel->setMotorTorque(kernelHandle, toBulletUnits(motorTorque) * HINGE_AXIS);
     }
-    convexPart.applyAngularImpulse(convexBasis * (convexImpulse * HINGE_AXIS));
-    concavePart.applyAngularImpulse(convexBasis * (concaveImpulse * HINGE_AXIS));
 }
 
-void CylindricJoint::beforeTick(World& world, Scalar<BulletUnits::Time> timeStep) {
-    btMatrix3x3 basis = convexPart.getEngineTransform().getBasis() * jointInfo.convexTransform.getBasis();
-    // friction
-    applyFriction(timeStep, basis);
-    // motor
-    btVector3 axis = basis * HINGE_AXIS;
-    Vector3<SI::Torque> totalTorque = motorTorque * axis;
-    convexPart.getBulletBody().applyTorque(toBulletUnits(totalTorque));
-    concavePart.getBulletBody().applyTorque(-toBulletUnits(totalTorque));
+void CylindricJoint::saveState(std::ostream& stream) const {
+    writeBinary<btScalar>(stream, motorTorque.value);
+    writeBinary<btScalar>(stream, wakeTorque.dot(HINGE_AXIS));
+}
+
+void CylindricJoint::loadState(std::istream& stream) {
+    motorTorque.value = readBinary<btScalar>(stream);
+    wakeTorque = readBinary<btScalar>(stream) * HINGE_AXIS;
+    updateKernelTorque();
 }
 
 Scalar<SI::Angle> CylindricJoint::getRotation() {
@@ -125,6 +121,6 @@ ActionSignal& CylindricJoint::getMotorAction() {
 
 void CylindricJoint::setMotorTorque(Scalar<SI::Torque> value) {
     motorTorque = std::clamp(value, -jointInfo.maxMotorTorque, jointInfo.maxMotorTorque);
-    concavePart.getBulletBody().activate();
-    convexPart.getBulletBody().activate();
+    updateKernelTorque();
+    wakeOnTorqueChange(toBulletUnits(motorTorque) * HINGE_AXIS, toBulletUnits(jointInfo.maxMotorTorque) * HINGE_AXIS);
 }
@@ -19,6 +19,7 @@
 #include "CylinderShape.hpp"
 #include "CylindricJoint.hpp"
 #include "CylindricJointInfo.hpp"
+#include "MemoryPool.hpp"
 #include "lua/bindings/bullet.hpp"
 #include "lua/bindings/FundamentalTypes.hpp"
 #include "lua/types/LuaNativeString.hpp"
@@ -27,12 +28,12 @@ void CylindricJointInfo::addConvexShape(std::vector<CompoundShape::ChildInfo>& i
     if (generateConvexShape) {
         Vector3<SI::Length> halfExtents(cylinderRadius, cylinderLength/2, cylinderRadius);
         Transform<SI::Length> transform = convexTransform * Transform<SI::Length>(btQuaternion(btVector3(0,0,1), SIMD_HALF_PI));
-        info.push_back({std::make_shared<CylinderShape>(jointDensity, halfExtents), transform});
+        info.push_back({CylinderShape::makeShared(jointDensity, halfExtents), transform});
     }
 }
 
-std::unique_ptr<Joint> CylindricJointInfo::makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const {
-    return std::make_unique<CylindricJoint>(convexPart, concavePart, *this, placeConvex);
+std::shared_ptr<Joint> CylindricJointInfo::makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const {
+    return makePooled<CylindricJoint>(convexPart, concavePart, *this, placeConvex);
 }
 
 std::unique_ptr<CylindricJointInfo> CylindricJointInfo::luaGetFromTable(LuaTable& table) {
@@ -16,7 +16,9 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <memory>
+#include <sstream>
 #include <tuple>
 #include <vector>
 
@@ -34,6 +36,7 @@
 #include "lua/LuaBinding.hpp"
 #include "lua/types/LuaMethod.hpp"
 #include "lua/types/LuaNativeString.hpp"
+#include "MemoryPool.hpp"
 #include "MinimumSpanningTree.hpp"
 #include "RobotBody.hpp"
 #include "SphereShape.hpp"
@@ -44,8 +47,10 @@
 
 RobotBody::ConstructionInfo::ConstructionInfo(const std::unordered_map<std::string, std::shared_ptr<Shape>>& parts,
                                               const std::string& basePartName,
-                                              const std::unordered_map<std::string, JointInputData>& joints) :
-    basePartName(basePartName)
+                                              const std::unordered_map<std::string, JointInputData>& joints,
+                                              const CollisionFilter& collisionFilter) :
+    basePartName(basePartName),
+    collisionFilter(collisionFilter)
 {
     UndirectedGraph<std::string,std::string> graph;
     std::unordered_map<std::string,std::vector<CompoundShape::ChildInfo>> shapeInfos;
@@ -105,7 +110,7 @@ RobotBody::ConstructionInfo::ConstructionInfo(const std::unordered_map<std::stri
         } else {
             auto& childInfos = it->second;
             childInfos.push_back({pair.second, Transform<SI::Length>::getIdentity()});
-            this->parts[pair.first] = std::make_shared<CompoundShape>(childInfos);
+            this->parts[pair.first] = CompoundShape::makeShared(childInfos);
         }
     }
 }
@@ -123,10 +128,33 @@ const std::vector<RobotBody::ConstructionInfo::JointData>& RobotBody::Constructi
 }
 
 RobotBody::RobotBody(World& world, std::shared_ptr<const ConstructionInfo> cInfo) :
-    info(cInfo)
+    RobotBody(std::move(cInfo))
 {
+    addToWorld(world);
+}
+
+RobotBody::RobotBody(World& world, const RobotBody& source) :
+    RobotBody(source.info)
+{
+    for (auto& pair : parts) {
+        pair.second->copyState(*source.parts.at(pair.first));
+    }
+    std::stringstream jointStates;
+    for (auto& pair : joints) {
+        source.joints.at(pair.first)->saveState(jointStates);
+        pair.second->loadState(jointStates);
+    }
+    addToWorld(world);
+}
+
+RobotBody::RobotBody(std::shared_ptr<const ConstructionInfo> cInfo) :
+    info(std::move(cInfo)),
+    world(nullptr)
+{
+    const auto& collisionFilter = info->getCollisionFilter();
     for (const auto& pair : info->getParts()) {
-        std::shared_ptr<Body> body = std::make_shared<Body>(pair.second);
+        std::shared_ptr<Body> body = makePooled<Body>(pair.second);
+        body->setCollisionFilter(collisionFilter.group, collisionFilter.mask);
         if (pair.first == info->getBasePartName()) {
             baseBody = body.get();
         }
@@ -138,12 +166,18 @@ RobotBody::RobotBody(World& world, std::shared_ptr<const ConstructionInfo> cInfo
         const JointInfo& jointInfo = *jointData.jointInfo;
         Body& convexPart = *parts[jointData.convexPartName];
         Body& concavePart = *parts[jointData.concavePartName];
-        std::unique_ptr<Joint> newJoint = jointInfo.makeJoint(convexPart, concavePart, jointData.placeConvex);
+        if (!collisionFilter.adjacentCollisions) {
+            convexPart.disableCollisionsWith(concavePart);
+        }
+        std::shared_ptr<Joint> newJoint = jointInfo.makeJoint(convexPart, concavePart, jointData.placeConvex);
         senses[jointData.jointName + ".rotation"] = &newJoint->getRotationSense();
         actions[jointData.jointName + ".motor"] = &newJoint->getMotorAction();
         joints[jointData.jointName] = std::move(newJoint);
     }
+}
 
+void RobotBody::addToWorld(World& world) {
+    this->world = &world;
     for (auto& pair : parts) {
         world.addObject(pair.second);
     }
@@ -152,8 +186,44 @@ RobotBody::RobotBody(World& world, std::shared_ptr<const ConstructionInfo> cInfo
     }
 }
 
+void RobotBody::removeFromWorld() {
+    if (world != nullptr) {
+        // Parts (and their joints) might have been removed one by one (World:removeBody()).
+        for (auto& pair : joints) {
+            if (world->hasConstraint(*pair.second)) {
+                world->removeConstraint(*pair.second);
+            }
+        }
+        for (auto& pair : parts) {
+            if (world->hasObject(*pair.second)) {
+                world->removeObject(*pair.second);
+            }
+        }
+        world = nullptr;
+    }
+}
+
 RobotBody::~RobotBody() = default;
 
+bool RobotBody::isSleeping() const {
+    return std::all_of(parts.begin(), parts.end(), [](const auto& pair) {
+        return pair.second->isSleeping();
+    });
+}
+
+/**
+ * Gets the world of a robot body, for a Lua method moving the robot.
+ *
+ * @param world World containing the robot (can be null).
+ * @return The world of the robot.
+ */
+static World& getWorldToMove(World* world) {
+    if (world == nullptr) {
+        throw LuaException("RobotBody: cannot move a robot removed from its world.");
+    }
+    return *world;
+}
+
 int RobotBody::luaIndex(const std::string& memberName, LuaStateView& state) {
     using Method = LuaMethod<RobotBody>;
     int result = 1;
@@ -164,6 +234,7 @@ int RobotBody::luaIndex(const std::string& memberName, LuaStateView& state) {
             Body& base = *object.baseBody;
             auto newPos = state.get<Vector3<SI::Length>>(2);
             auto translation = newPos - base.getPosition();
+            World::TransformBatch batch(getWorldToMove(object.world));
             for (auto& part : object.parts) {
                 part.second->setPosition(part.second->getPosition() + translation);
             }
@@ -177,6 +248,7 @@ int RobotBody::luaIndex(const std::string& memberName, LuaStateView& state) {
             const auto& curTransform = base.getEngineTransform();
             const btTransform relRotation(state.get<btQuaternion>(2) * curTransform.getRotation().inverse());
             btTransform relTransform(curTransform * relRotation * curTransform.inverse());
+            World::TransformBatch batch(getWorldToMove(object.world));
             for (auto& part : object.parts) {
                 part.second->setEngineTransform(relTransform*part.second->getEngineTransform());
             }
@@ -202,6 +274,8 @@ int RobotBody::luaIndex(const std::string& memberName, LuaStateView& state) {
             }
             return object.parts.size();
         });
+    } else if (memberName=="sleeping") {
+        state.push<bool>(isSleeping());
     } else if (memberName=="aiInterface") {
         state.push<AIInterface*>(&aiInterface);
     } else {
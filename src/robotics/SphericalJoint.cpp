@@ -18,8 +18,8 @@
 
 #include <algorithm>
 
+#include "BinaryStream.hpp"
 #include "SphericalJoint.hpp"
-#include "units/Matrix3x3.hpp"
 
 static void initPosition(const Body& fixedBody, const Transform<SI::Length>& fixedJoint, Body& movingBody,
                          const Transform<SI::Length>& movingJoint, const btQuaternion& rotation)
@@ -44,7 +44,10 @@ SphericalJoint::SphericalJoint(Body& ball, Body& socket, const SphericalJointInf
     constraint(makeConstraint(ball, socket, info)),
     rotationSense([this]() -> btQuaternion { return this->getRotation(); }),
     motorTorque(0,0,0),
-    motorAction([this](const btVector3& value) { this->setMotorTorque(Vector3<SI::Torque>(value)); })
+    motorAction(
+        [this](const btVector3& value) { this->setMotorTorque(Vector3<SI::Torque>(value)); },
+        [this]() { this->wakeUp(); }
+    )
 {
     if (placeBall) {
         initPosition(socket, info.concaveTransform, ball, info.convexTransform, info.startRotation);
@@ -55,42 +58,38 @@ SphericalJoint::SphericalJoint(Body& ball, Body& socket, const SphericalJointInf
 
 SphericalJoint::~SphericalJoint() = default;
 
-void SphericalJoint::applyFriction(const Scalar<BulletUnits::Time> timeStep, const btMatrix3x3& convexBasis) {
-    Vector3<SI::AngularVelocity> relativeVelocity = concavePart.getAngularVelocity() - convexPart.getAngularVelocity();
-    Vector3<SI::AngularVelocity> refVelocity = convexBasis.inverse() * relativeVelocity;
-    Vector3<SI::Torque> refFriction(
-        refVelocity.x() * jointInfo.frictionCoefficients.x(),
-        refVelocity.y() * jointInfo.frictionCoefficients.y(),
-        refVelocity.z() * jointInfo.frictionCoefficients.z()
-    );
-    auto computeImpulse = [this,timeStep](const Body& body, const Vector3<SI::Torque>& torque) -> Vector3<SI::AngularVelocity> {
-        const auto& basis = this->jointInfo.convexTransform.getBasis();
-        return Matrix3x3<SI::NoUnit>(basis.transpose()).scaled(body.getInvInertiaDiagLocal()) * (basis * torque * timeStep * Scalar<SI::Angle>(1));
-    };
-    Vector3<SI::AngularVelocity> convexImpulse = computeImpulse(convexPart, refFriction);
-    Vector3<SI::AngularVelocity> concaveImpulse = computeImpulse(concavePart, -refFriction);
-    Vector3<SI::AngularVelocity> newRelVelocity = refVelocity + concaveImpulse - convexImpulse;
-    for (int i=0; i<3; i++) {
-        auto prevVel = refVelocity.value.m_floats[i];
-        auto newVel = newRelVelocity.value.m_floats[i];
-        if (newVel * prevVel < 0) {
-            float factor = fabs(prevVel / (prevVel - newVel));
-            convexImpulse.value.m_floats[i] *= factor;
-            concaveImpulse.value.m_floats[i] *= factor;
-        }
+std::optional<JointKernel::Handle> SphericalJoint::addToKernel(JointKernel& newKernel) {
+    kernelHandle = newKernel.add(convexPart.getBulletBody(), concavePart.getBulletBody(),
+                                 jointInfo.convexTransform.getBasis(), toBulletUnits(jointInfo.frictionCoefficients),
+                                 btVector3(1,1,1));
+    kernel = &newKernel;
+    updateKernelTorque();
+    return kernelHandle;
+}
+
+void SphericalJoint::updateKernelTorque() {
+    if (kernel != nullptr) {
+        kernel->setMotorTorque(kernelHandle, toBulletUnits(motorTorque));
     }
-    convexPart.applyAngularImpulse(convexBasis * convexImpulse);
-    concavePart.applyAngularImpulse(convexBasis * concaveImpulse);
 }
 
-void SphericalJoint::beforeTick(World& world, Scalar<BulletUnits::Time> timeStep) {
-    btMatrix3x3 basis = convexPart.getEngineTransform().getBasis() * jointInfo.convexTransform.getBasis();
-    // Friction
-    applyFriction(timeStep, basis);
-    // Motor
-    Vector3<SI::Torque> absMotorTorque = basis * motorTorque;
-    convexPart.getBulletBody().applyTorque(toBulletUnits(absMotorTorque));
-    concavePart.getBulletBody().applyTorque(-toBulletUnits(absMotorTorque));
+void SphericalJoint::saveState(std::ostream& stream) const {
+    for (int i = 0; i < 3; i++) {
+        writeBinary<btScalar>(stream, motorTorque.value[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        writeBinary<btScalar>(stream, wakeTorque[i]);
+    }
+}
+
+void SphericalJoint::loadState(std::istream& stream) {
+    for (int i = 0; i < 3; i++) {
+        motorTorque.value[i] = readBinary<btScalar>(stream);
+    }
+    for (int i = 0; i < 3; i++) {
+        wakeTorque[i] = readBinary<btScalar>(stream);
+    }
+    updateKernelTorque();
 }
 
 btQuaternion SphericalJoint::getRotation() const {
@@ -114,6 +113,6 @@ void SphericalJoint::setMotorTorque(const Vector3<SI::Torque>& value) {
         std::clamp(value.y(), -maxTorque.y(), maxTorque.y()),
         std::clamp(value.z(), -maxTorque.z(), maxTorque.z()),
     };
-    convexPart.getBulletBody().activate();
-    concavePart.getBulletBody().activate();
+    updateKernelTorque();
+    wakeOnTorqueChange(toBulletUnits(motorTorque), toBulletUnits(maxTorque));
 }
@@ -16,6 +16,7 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "MemoryPool.hpp"
 #include "SphereShape.hpp"
 #include "SphericalJoint.hpp"
 #include "SphericalJointInfo.hpp"
@@ -25,12 +26,12 @@
 
 void SphericalJointInfo::addConvexShape(std::vector<CompoundShape::ChildInfo>& shapeInfo) const {
     if (generateConvexShape) {
-        shapeInfo.push_back({std::make_shared<SphereShape>(jointDensity, ballRadius), convexTransform});
+        shapeInfo.push_back({SphereShape::makeShared(jointDensity, ballRadius), convexTransform});
     }
 }
 
-std::unique_ptr<Joint> SphericalJointInfo::makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const {
-    return std::make_unique<SphericalJoint>(convexPart, concavePart, *this, placeConvex);
+std::shared_ptr<Joint> SphericalJointInfo::makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const {
+    return makePooled<SphericalJoint>(convexPart, concavePart, *this, placeConvex);
 }
 
 std::unique_ptr<SphericalJointInfo> SphericalJointInfo::luaGetFromTable(LuaTable& table) {
@@ -20,6 +20,7 @@
 #define CYLINDRICJOINT_HPP
 
 #include <memory>
+#include <optional>
 
 #include "Action.hpp"
 #include "Body.hpp"
@@ -54,7 +55,11 @@ public:
         return constraint;
     }
 
-    void beforeTick(World& world, Scalar<BulletUnits::Time> timeStep) override;
+    std::optional<JointKernel::Handle> addToKernel(JointKernel& kernel) override;
+
+    void saveState(std::ostream& stream) const override;
+
+    void loadState(std::istream& stream) override;
 
     virtual ~CylindricJoint();
 
@@ -85,13 +90,8 @@ private:
      */
     void setMotorTorque(Scalar<SI::Torque> value);
 
-    /**
-     * Apply an impulse on both body parts to simulate the friction.
-     *
-     * @param timeStep Duration of the next integration step.
-     * @param convexBasis Basis of the convex part of the joint (joint space -> absolute space).
-     */
-    void applyFriction(const Scalar<BulletUnits::Time> timeStep, const btMatrix3x3& convexBasis);
+    /** Copies motorTorque into the joint kernel (if any). */
+    void updateKernelTorque();
 };
 
 #endif /* CYLINDRICJOINT_HPP */
@@ -82,7 +82,7 @@ struct CylindricJointInfo : public JointInfo {
 
     void addConvexShape(std::vector<CompoundShape::ChildInfo>& shapeInfo) const override;
 
-    std::unique_ptr<Joint> makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const override;
+    std::shared_ptr<Joint> makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const override;
 
     /**
      * Creates a CylindricJointInfo object from the content of a Lua table.
@@ -26,6 +26,7 @@
 #include "ActionSignal.hpp"
 #include "Body.hpp"
 #include "Constraint.hpp"
+#include "JointKernel.hpp"
 #include "SenseSignal.hpp"
 
 /** Common interface for all joint types. */
@@ -35,13 +36,63 @@ protected:
     Body& convexPart;
     /** Body part holding the concave part of the joint. */
     Body& concavePart;
+    /** Kernel computing the friction & motor of this joint (nullptr if not in a World). */
+    JointKernel* kernel;
+    /** Handle of this joint in kernel. */
+    JointKernel::Handle kernelHandle;
+    /** Motor torque (engine units) at the last wake up of the body parts (see wakeOnTorqueChange()). */
+    btVector3 wakeTorque;
+
+    /**
+     * Variation of the motor torque waking up the body parts, relative to the maximum torque of the motor.
+     */
+    static constexpr btScalar WAKE_TORQUE_RATIO = btScalar(0.02);
+
+    /**
+     * Wakes up the body parts of this joint if the motor torque changed meaningfully.
+     *
+     * Activating a body resets its deactivation timer: a motor waking up its parts at
+     * every step would prevent a robot standing still from ever falling asleep. The
+     * parts are woken up only when the torque moved away from the torque of the last
+     * wake up by more than WAKE_TORQUE_RATIO of the maximum torque (on any axis).
+     *
+     * @param torque New motor torque (engine units).
+     * @param maxTorque Maximum motor torque on each axis (engine units).
+     */
+    void wakeOnTorqueChange(const btVector3& torque, const btVector3& maxTorque) {
+        btVector3 delta = (torque - wakeTorque).absolute();
+        btVector3 threshold = WAKE_TORQUE_RATIO * maxTorque;
+        if (delta.x() > threshold.x() || delta.y() > threshold.y() || delta.z() > threshold.z()) {
+            wakeTorque = torque;
+            wakeUp();
+        }
+    }
+
+    /**
+     * Wakes up the body parts of this joint, whatever the variation of the motor torque.
+     *
+     * Used when the motor command is changed on purpose (see Action::wake()): a small
+     * change of target might not move the torque enough to wake the parts up.
+     */
+    void wakeUp() {
+        convexPart.getBulletBody().activate();
+        concavePart.getBulletBody().activate();
+    }
 public:
     /**
      * Creates a new Joint.
      * @param convexPart Body part containing the convex part of the joint.
      * @param concavePart Body part containing the concave part of the joint.
      */
-    Joint(Body& convexPart, Body& concavePart) : convexPart(convexPart), concavePart(concavePart) {}
+    Joint(Body& convexPart, Body& concavePart) :
+        convexPart(convexPart),
+        concavePart(concavePart),
+        kernel(nullptr),
+        kernelHandle(0),
+        wakeTorque(0,0,0)
+    {
+
+    }
 
     Joint(const Joint&) = delete;
     Joint(Joint&&) = delete;
@@ -62,6 +113,11 @@ public:
         return concavePart;
     }
 
+    void removeFromKernel(JointKernel& oldKernel) override {
+        oldKernel.remove(kernelHandle);
+        kernel = nullptr;
+    }
+
     virtual ~Joint() = default;
 
     /**
@@ -69,7 +69,7 @@ public:
      * @param concavePart Body containing the concave part of the joint.
      * @param placeConvex True to place the convex part according to the position of the concave part. False otherwise.
      */
-    virtual std::unique_ptr<Joint> makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const = 0;
+    virtual std::shared_ptr<Joint> makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const = 0;
 
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
 
@@ -65,15 +65,41 @@ public:
             std::string concavePartName;
         };
 
+        /** Collision filtering of the body parts of a robot. */
+        struct CollisionFilter {
+            /** Creates the default filter (same as a Body, self collisions enabled). */
+            CollisionFilter() :
+                group(btBroadphaseProxy::DefaultFilter),
+                mask(btBroadphaseProxy::AllFilter),
+                adjacentCollisions(true)
+            {
+
+            }
+
+            /** Bitfield of the collision groups of the body parts (see Body::setCollisionFilter()). */
+            int group;
+            /** Bitfield of the collision groups the body parts collide with. */
+            int mask;
+            /**
+             * Flag set when parts linked by a joint can collide with each other.
+             *
+             * When false, the broadphase never generates pairs between adjacent parts of
+             * the joint tree (ex: torso & arm).
+             */
+            bool adjacentCollisions;
+        };
+
         /**
          * Creates a new ConstructionInfo object.
          * @param parts Map of body part shapes, indexed by their names in the RobotBody.
          * @param basePartName Name of the base part in the RobotBody.
          * @param joints Map of tuples <JointInfo, convexPartName, concavePartName>, indexed by the joint name.
+         * @param collisionFilter Collision filtering of the body parts.
          */
         ConstructionInfo(const std::unordered_map<std::string, std::shared_ptr<Shape>>& parts,
                          const std::string& basePartName,
-                         const std::unordered_map<std::string, JointInputData>& joints);
+                         const std::unordered_map<std::string, JointInputData>& joints,
+                         const CollisionFilter& collisionFilter = CollisionFilter());
 
         /**
          * Gets the set of body parts names and their shapes.
@@ -97,6 +123,14 @@ public:
          * @return A vector containing construction data for the joints.
          */
         const std::vector<JointData>& getJoints() const;
+
+        /**
+         * Gets the collision filtering of the body parts.
+         * @return The collision filter of the body parts.
+         */
+        const CollisionFilter& getCollisionFilter() const {
+            return collisionFilter;
+        }
     private:
 
         /** Map of body part shapes, indexed by their names. */
@@ -105,6 +139,8 @@ public:
         std::string basePartName;
         /** Set of Joint construction data (infixed depth-first order from the root). */
         std::vector<JointData> joints;
+        /** Collision filtering of the body parts. */
+        CollisionFilter collisionFilter;
     };
 
     /**
@@ -114,8 +150,37 @@ public:
      */
     RobotBody(World& world, std::shared_ptr<const ConstructionInfo> cInfo);
 
+    /**
+     * Creates a copy of a robot body in another world.
+     *
+     * The construction info (shapes & joint infos) is shared with the source. The
+     * dynamic state of the body parts & joints is copied.
+     *
+     * @param world World in which the copy will be created.
+     * @param source Robot body to copy.
+     */
+    RobotBody(World& world, const RobotBody& source);
+
     virtual ~RobotBody();
 
+    /**
+     * Removes the joints & body parts of this robot from its world.
+     *
+     * Parts & joints already removed from the world (see World::removeObject()) are
+     * skipped. The robot can't be moved afterwards.
+     */
+    void removeFromWorld();
+
+    /**
+     * Tests if all the body parts of this robot are sleeping.
+     *
+     * Scenes skip the AI of sleeping robots. A new command (ActionSignal set from Lua,
+     * new target of a feedback loop) wakes up the body parts of its joint.
+     *
+     * @return True if every body part is sleeping.
+     */
+    bool isSleeping() const;
+
     int luaIndex(const std::string& memberName, LuaStateView& state) override;
 
     /**
@@ -126,6 +191,14 @@ public:
         return aiInterface;
     }
 
+    /**
+     * Gets the body parts of this robot.
+     * @return The body parts, indexed by their names.
+     */
+    const std::unordered_map<std::string, std::shared_ptr<Body>>& getParts() const {
+        return parts;
+    }
+
     /**
      * Constructs a new RobotBody from a Lua table.
      * @param table Table containing the parameters of the new RobotBody.
@@ -143,6 +216,20 @@ private:
     Body* baseBody;
     /** Interface (input/output signals) for an AI. */
     AIInterface aiInterface;
+    /** World containing this body (null until addToWorld() is called, or after removeFromWorld()). */
+    World* world;
+
+    /**
+     * Creates the body parts & joints of a robot body, without adding them to a world.
+     * @param info Construction info for the robot.
+     */
+    RobotBody(std::shared_ptr<const ConstructionInfo> cInfo);
+
+    /**
+     * Adds the body parts & joints into a world.
+     * @param world World in which the body parts & joints are added.
+     */
+    void addToWorld(World& world);
 };
 
 #endif /* ROBOTBODY_HPP */
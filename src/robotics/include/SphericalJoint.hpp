@@ -20,6 +20,7 @@
 #define SPHERICALJOINT_HPP
 
 #include <memory>
+#include <optional>
 
 #include "btBulletDynamicsCommon.h"
 
@@ -56,7 +57,11 @@ public:
         return constraint;
     }
 
-    void beforeTick(World& world, Scalar<BulletUnits::Time> timeStep) override;
+    std::optional<JointKernel::Handle> addToKernel(JointKernel& kernel) override;
+
+    void saveState(std::ostream& stream) const override;
+
+    void loadState(std::istream& stream) override;
 
     /**
      * Gets the relative transform of the ball in the socket frame.
@@ -85,13 +90,8 @@ private:
      */
     void setMotorTorque(const Vector3<SI::Torque>& value);
 
-    /**
-     * Apply an impulse on both body parts to simulate the friction.
-     *
-     * @param timeStep Duration of the next integration step.
-     * @param convexBasis Basis of the convex part of the joint (joint space -> absolute space).
-     */
-    void applyFriction(const Scalar<BulletUnits::Time> timeStep, const btMatrix3x3& convexBasis);
+    /** Copies motorTorque into the joint kernel (if any). */
+    void updateKernelTorque();
 };
 
 #endif /* JOINT_HPP */
@@ -79,7 +79,7 @@ public:
 
     void addConvexShape(std::vector<CompoundShape::ChildInfo>& shapeInfo) const override;
 
-    std::unique_ptr<Joint> makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const override;
+    std::shared_ptr<Joint> makeJoint(Body& convexPart, Body& concavePart, bool placeConvex) const override;
 
     /**
      * Creates a SphericalJointInfo object from the content of a Lua table.
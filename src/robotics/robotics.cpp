@@ -16,7 +16,11 @@
  * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+#include <limits>
+
 #include "JointInfo.hpp"
+#include "lua/bindings/FundamentalTypes.hpp"
 #include "lua/bindings/luaVirtualClass/shared_ptr.hpp"
 #include "lua/bindings/robotics.hpp"
 #include "lua/bindings/std/string.hpp"
@@ -31,11 +35,37 @@ std::unordered_map<K,V> getMap(LuaTable& table, const char* fieldName) {
     return subTable.asMap<K,V>();
 }
 
+/**
+ * Reads an optional collision bitfield from a Lua table.
+ * @param table Lua table containing the field.
+ * @param fieldName Name of the field.
+ * @param defaultValue Value returned if the field is absent.
+ * @return The bitfield.
+ */
+static int getCollisionBits(LuaTable& table, const char* fieldName, int defaultValue) {
+    int result = defaultValue;
+    if (table.has<LuaNativeString>(fieldName)) {
+        double value = table.get<LuaNativeString,double>(fieldName);
+        if (value != std::floor(value) || value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+            std::string msg = std::string("RobotInfo: '") + fieldName + "' must be a 32-bit integer bitfield.";
+            throw LuaException(msg.c_str());
+        }
+        result = static_cast<int>(value);
+    }
+    return result;
+}
+
 RobotBody::ConstructionInfo LuaBinding<RobotBody::ConstructionInfo>::getFromTable(LuaTable& table) {
     auto parts = getMap<std::string,std::shared_ptr<Shape>>(table, "parts");
     auto base = table.get<LuaNativeString,std::string>("basePart");
     auto joints = getMap<std::string,JointInputData>(table, "joints");
-    return ConstructionInfo(parts, base, joints);
+    ConstructionInfo::CollisionFilter collisionFilter;
+    collisionFilter.group = getCollisionBits(table, "collisionGroup", collisionFilter.group);
+    collisionFilter.mask = getCollisionBits(table, "collisionMask", collisionFilter.mask);
+    if (table.has<LuaNativeString>("adjacentCollisions")) {
+        collisionFilter.adjacentCollisions = table.get<LuaNativeString,bool>("adjacentCollisions");
+    }
+    return ConstructionInfo(parts, base, joints, collisionFilter);
 }
 
 JointInputData LuaBinding<JointInputData>::getFromTable(LuaTable& table) {
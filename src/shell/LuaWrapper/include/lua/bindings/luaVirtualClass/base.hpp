@@ -87,8 +87,10 @@ private:
 
     /** True if <code>unique_ptr<T> luaGetFromTable(...);</code> can be turned into a constructor form Lua table. */
     static constexpr bool can_getFromTable_ptr_T = (Traits::has_getFromTable_ptr_T && Traits::is_copy_or_move_constructible);
+    /** True if <code>shared_ptr<T> luaGetFromTable(...);</code> can be turned into a constructor form Lua table. */
+    static constexpr bool can_getFromTable_shared_T = (Traits::has_getFromTable_shared_T && Traits::is_copy_or_move_constructible);
     /** True if this type has a constructor from Lua table. */
-    static constexpr bool has_table_constructor = can_getFromTable_ptr_T || Traits::has_getFromTable_T;
+    static constexpr bool has_table_constructor = can_getFromTable_ptr_T || can_getFromTable_shared_T || Traits::has_getFromTable_T;
 
     /**
      * Upcast a pointer from base T to LuaVirtualClass.
@@ -235,6 +237,9 @@ public:
         } else if constexpr (can_getFromTable_ptr_T) {
             std::unique_ptr<T> ptr = T::luaGetFromTable(table);
             return *ptr;
+        } else if constexpr (can_getFromTable_shared_T) {
+            std::shared_ptr<T> ptr = T::luaGetFromTable(table);
+            return *ptr;
         }
     }
 
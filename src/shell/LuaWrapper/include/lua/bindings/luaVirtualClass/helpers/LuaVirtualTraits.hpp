@@ -38,6 +38,13 @@ namespace LuaTraitsImpl {
 
     template<typename T>
     struct has_getFromTable_ptr_T<T, typename std::enable_if<std::is_same<std::unique_ptr<T>,decltype(T::luaGetFromTable(std::declval<LuaTable&>()))>::value>::type> : std::true_type {};
+
+    /** SFINAE implementation of LuaVirtualTraits::has_getFromTable_shared_T. */
+    template<typename T, typename Enable=void>
+    struct has_getFromTable_shared_T : std::false_type {};
+
+    template<typename T>
+    struct has_getFromTable_shared_T<T, typename std::enable_if<std::is_same<std::shared_ptr<T>,decltype(T::luaGetFromTable(std::declval<LuaTable&>()))>::value>::type> : std::true_type {};
 }
 
 /** Defines some traits for C++ types deriving from LuaVirtualClass binded to Lua. */
@@ -48,6 +55,8 @@ public:
     static constexpr bool has_getFromTable_T = LuaTraitsImpl::has_getFromTable_T<T>::value;
     /** True if T defines <code>static std::unique_ptr<T> luaGetFromTable(LuaTable&);</code>. */
     static constexpr bool has_getFromTable_ptr_T = LuaTraitsImpl::has_getFromTable_ptr_T<T>::value;
+    /** True if T defines <code>static std::shared_ptr<T> luaGetFromTable(LuaTable&);</code>. */
+    static constexpr bool has_getFromTable_shared_T = LuaTraitsImpl::has_getFromTable_shared_T<T>::value;
     /** True if this type is copy constructible or move constructible. */
     static constexpr bool is_copy_or_move_constructible = std::is_copy_constructible<T>::value || std::is_move_constructible<T>::value;
 };
@@ -134,7 +134,7 @@ private:
     /** True if <code>static T getFromTable(...);</code> can be turned into a constructor form Lua table. */
     static constexpr bool can_getFromTable = Traits::has_getFromTable_T && Traits::is_copy_or_move_constructible;
     /** True if BoundType can be constructed from a Lua table. */
-    static constexpr bool has_table_constructor = can_getFromTable || Traits::has_getFromTable_ptr_T;
+    static constexpr bool has_table_constructor = can_getFromTable || Traits::has_getFromTable_ptr_T || Traits::has_getFromTable_shared_T;
 
     /**
      * Constructs a BoundType object from a Lua table in the stack.
@@ -143,7 +143,9 @@ private:
      */
     template<typename T=BoundType>
     static typename std::enable_if<has_table_constructor,T>::type getFromTable(LuaTable& table) {
-        if constexpr (Traits::has_getFromTable_ptr_T) {
+        if constexpr (Traits::has_getFromTable_shared_T) {
+            return PointedType::luaGetFromTable(table);
+        } else if constexpr (Traits::has_getFromTable_ptr_T) {
             return BoundType(PointedType::luaGetFromTable(table));
         } else if constexpr (can_getFromTable) {
             return std::make_shared<PointedType>(PointedType::luaGetFromTable(table));
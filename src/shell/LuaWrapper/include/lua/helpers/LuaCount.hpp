@@ -0,0 +1,46 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LUACOUNT_HPP
+#define LUACOUNT_HPP
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/**
+ * Tests if a Lua number can be converted into a count.
+ *
+ * Lua numbers are doubles: NaN, infinities, fractional values and values out
+ * of the range of T are rejected, so that the static_cast<T> of a valid value
+ * is exact.
+ *
+ * @param[in] value Lua number to test.
+ * @param[in] minValue Minimum accepted value.
+ * @return True if value is a whole number in [minValue, max of T].
+ * @tparam T Unsigned integer type of the count.
+ */
+template<typename T>
+bool isLuaCount(double value, T minValue) {
+    static_assert(std::is_unsigned<T>::value, "isLuaCount<T>: T must be an unsigned integer type.");
+    // 2^digits is exactly representable, unlike numeric_limits<T>::max() for 64-bit types.
+    const double upperBound = std::ldexp(1.0, std::numeric_limits<T>::digits);
+    return value >= minValue && value < upperBound && value == std::floor(value);
+}
+
+#endif /* LUACOUNT_HPP */
@@ -0,0 +1,54 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <catch.hpp>
+
+#include "lua/helpers/LuaCount.hpp"
+
+TEST_CASE("isLuaCount()") {
+    SECTION("Whole numbers in range") {
+        REQUIRE(isLuaCount<unsigned>(1, 1));
+        REQUIRE(isLuaCount<unsigned>(42, 0));
+        REQUIRE(isLuaCount<std::uint32_t>(4294967295.0, 1));
+    }
+
+    SECTION("Below the minimum") {
+        REQUIRE_FALSE(isLuaCount<unsigned>(0, 1));
+        REQUIRE_FALSE(isLuaCount<unsigned>(-1, 0));
+    }
+
+    SECTION("Fractional values") {
+        REQUIRE_FALSE(isLuaCount<unsigned>(2.5, 1));
+        REQUIRE_FALSE(isLuaCount<unsigned>(0.5, 0));
+    }
+
+    SECTION("Out of range") {
+        REQUIRE_FALSE(isLuaCount<std::uint32_t>(4294967296.0, 1));
+        REQUIRE_FALSE(isLuaCount<std::uint64_t>(18446744073709551616.0, 1));
+    }
+
+    SECTION("NaN & infinities") {
+        REQUIRE_FALSE(isLuaCount<std::size_t>(std::numeric_limits<double>::quiet_NaN(), 0));
+        REQUIRE_FALSE(isLuaCount<std::size_t>(std::numeric_limits<double>::infinity(), 0));
+        REQUIRE_FALSE(isLuaCount<std::size_t>(-std::numeric_limits<double>::infinity(), 0));
+    }
+}
@@ -87,6 +87,20 @@ public:
     }
 };
 
+class Derived3 : public Base {
+public:
+    Derived3(bool value) : Base(value) {
+
+    }
+
+    static std::shared_ptr<Derived3> luaGetFromTable(LuaTable& table) {
+        static const std::shared_ptr<Derived3> trueObject = std::make_shared<Derived3>(true);
+        static const std::shared_ptr<Derived3> falseObject = std::make_shared<Derived3>(false);
+        bool value = table.get<LuaNativeString,bool>("baseValue");
+        return value ? trueObject : falseObject;
+    }
+};
+
 std::unique_ptr<Base> Base::luaGetFromTable(LuaTable& table) {
     std::string type(table.get<LuaNativeString,LuaNativeString>("type"));
     bool baseValue = table.get<LuaNativeString,bool>("baseValue");
@@ -510,5 +524,14 @@ TEST_CASE("std::shared_ptr<LuaVirtualClass> (derived shared_ptrs) bindings.") {
             std::shared_ptr<Derived2> derived2 = state.get<std::shared_ptr<Derived2>>(table.getStackIndex());
             REQUIRE(derived2->baseValue == BASE_VALUE);
         }
+
+        SECTION("shared_ptr<Derived3> table constructor (shared_ptr luaGetFromTable)") {
+            std::shared_ptr<Derived3> first = state.get<std::shared_ptr<Derived3>>(table.getStackIndex());
+            REQUIRE(first->baseValue == BASE_VALUE);
+            LuaTable other(state);
+            other.set<LuaNativeString,bool>("baseValue", BASE_VALUE);
+            std::shared_ptr<Derived3> second = state.get<std::shared_ptr<Derived3>>(other.getStackIndex());
+            REQUIRE(first == second);
+        }
     }
 }
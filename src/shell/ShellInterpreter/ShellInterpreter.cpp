@@ -23,8 +23,19 @@
 
 #include <iostream>
 
-ShellInterpreter::ShellInterpreter(ShellInterpreterConfig& config) : config(config) {
-    running = false;
+ShellInterpreter::ShellInterpreter(ShellInterpreterConfig& config) :
+    config(config),
+    initialised(false),
+    running(false)
+{
+
+}
+
+void ShellInterpreter::init() {
+    if (!initialised) {
+        initialised = true;
+        config.init(luaState);
+    }
 }
 
 /**
@@ -38,23 +49,29 @@ static auto& readLine(std::string& line) {
 }
 
 void ShellInterpreter::run() {
-    LuaState luaState;
     running = true;
 
-    config.init(luaState);
+    init();
 
     std::string line;
     while (running && readLine(line)) {
         config.beforeCommand(luaState);
-        try {
-            luaState.doString(line);
-        } catch (const LuaException &e) {
-            std::cerr << e.what() << std::endl;
-        }
+        execute(line);
         config.afterCommand(luaState);
     }
 }
 
+bool ShellInterpreter::execute(const std::string& command) {
+    bool result = true;
+    try {
+        config.execute(luaState, command);
+    } catch (const LuaException &e) {
+        std::cerr << e.what() << std::endl;
+        result = false;
+    }
+    return result;
+}
+
 void ShellInterpreter::quit() {
     running = false;
 }
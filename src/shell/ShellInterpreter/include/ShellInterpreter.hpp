@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 
+#include "lua/LuaState.hpp"
 #include "lua/types/LuaVirtualClass.hpp"
 #include "ShellInterpreterConfig.hpp"
 
@@ -40,13 +41,29 @@ public:
      */
     ShellInterpreter(ShellInterpreterConfig& config);
 
+    /**
+     * Initialises the Lua state of this shell (see ShellInterpreterConfig::init()).
+     *
+     * Does nothing if the shell is already initialised.
+     */
+    void init();
+
     /**
      * Run the shell.
      *
-     * It contains the main loop reading from standard input.
+     * It contains the main loop reading from standard input. The shell is
+     * initialised if init() wasn't called before.
      */
     void run();
 
+    /**
+     * Executes a single command (see ShellInterpreterConfig::execute()).
+     *
+     * @param[in] command Lua code to execute.
+     * @return True if the command was executed without errors.
+     */
+    bool execute(const std::string& command);
+
     /**
      * Set a flag making the shell to stop after evaluating the current statement.
      */
@@ -57,6 +74,10 @@ public:
 private:
     /** Shell configuration. */
     ShellInterpreterConfig& config;
+    /** Lua state of this shell. */
+    LuaState luaState;
+    /** Flag set once the Lua state is initialised. */
+    bool initialised;
     /** Flag telling if the main loop should keep running. */
     bool running;
 };
@@ -19,7 +19,7 @@
 #ifndef SHELLINTERPRETERCONFIG_HPP
 #define SHELLINTERPRETERCONFIG_HPP
 
-
+#include <string>
 
 #include "lua/LuaStateView.hpp"
 
@@ -36,16 +36,39 @@ public:
     /**
      * Called once before executing a new command from stdin.
      *
+     * The default implementation does nothing.
+     *
      * @param state The Lua state of the shell.
      */
-    virtual void beforeCommand(LuaStateView& state) = 0;
+    virtual void beforeCommand(LuaStateView& state) {
+
+    }
 
     /**
      * Called once after having executed a command from stdin.
      *
+     * The default implementation does nothing.
+     *
+     * @param state The Lua state of the shell.
+     */
+    virtual void afterCommand(LuaStateView& state) {
+
+    }
+
+    /**
+     * Executes a Lua command in the Lua state of the shell.
+     *
+     * The default implementation runs the command in the calling thread. It can be
+     * overriden to run the command in another thread. This function should return
+     * once the command has been executed, and propagate its exceptions. Exceptions
+     * of commands run asynchronously must be reported by the implementation.
+     *
      * @param state The Lua state of the shell.
+     * @param command Lua code to execute.
      */
-    virtual void afterCommand(LuaStateView& state) = 0;
+    virtual void execute(LuaStateView& state, const std::string& command) {
+        state.doString(command);
+    }
 
     virtual ~ShellInterpreterConfig() = default;
 };
@@ -0,0 +1,101 @@
+/*
+ * This file is part of Insight.
+ * Copyright (C) 2019 Vincent Saulue-Laborde <vincent_saulue@hotmail.fr>
+ *
+ * Insight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Insight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Insight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <stdexcept>
+
+#include <catch.hpp>
+
+#include "Body.hpp"
+#include "Scene.hpp"
+#include "SceneGroup.hpp"
+#include "SphereShape.hpp"
+#include "units/Scalar.hpp"
+#include "units/SI.hpp"
+#include "units/Vector3.hpp"
+
+/** Simulated time of a single step (in seconds). */
+static const double TICK_DURATION = 1.0 / 60;
+
+/** Creates a scene with a single sphere, falling from 10 m. */
+static std::shared_ptr<Scene> newScene() {
+    auto result = std::make_shared<Scene>(TICK_DURATION);
+    auto body = std::make_shared<Body>(SphereShape::makeShared(Scalar<SI::Mass>(1), Scalar<SI::Length>(0.5)));
+    body->setPosition(Vector3<SI::Length>(0.0, 10.0, 0.0));
+    result->getWorld().addObject(body);
+    return result;
+}
+
+/** Gets the height of the sphere of a scene created by newScene(). */
+static double getHeight(const Scene& scene) {
+    return (*scene.getWorld().begin())->getPosition().y().value;
+}
+
+TEST_CASE("SceneGroup: step() runs every scene of the group") {
+    SceneGroup group;
+    auto first = newScene();
+    auto second = newScene();
+    auto outside = newScene();
+    group.add(first);
+    group.add(second);
+    group.step(10);
+    group.step(20);
+    REQUIRE(getHeight(*first) < 10);
+    REQUIRE(getHeight(*second) == getHeight(*first));
+    REQUIRE(getHeight(*outside) == 10);
+    outside->stepSimulation(30u);
+    REQUIRE(getHeight(*outside) == getHeight(*first));
+}
+
+TEST_CASE("SceneGroup: removed scenes") {
+    SceneGroup group;
+    auto source = newScene();
+    auto fork = source->fork();
+    std::weak_ptr<Scene> weakFork = fork;
+    group.add(fork);
+    group.add(newScene());
+    group.step(5);
+    REQUIRE(group.size() == 2);
+
+    SECTION("A discarded fork is destroyed") {
+        group.remove(*fork);
+        REQUIRE(group.size() == 1);
+        fork.reset();
+        REQUIRE(weakFork.expired());
+        group.step(5);
+    }
+
+    SECTION("A fork is kept alive by the group until removed") {
+        fork.reset();
+        REQUIRE_FALSE(weakFork.expired());
+        group.remove(*weakFork.lock());
+        REQUIRE(weakFork.expired());
+    }
+
+    SECTION("A removed scene is no longer stepped") {
+        double height = getHeight(*fork);
+        group.remove(*fork);
+        group.step(5);
+        REQUIRE(getHeight(*fork) == height);
+    }
+
+    SECTION("Removing a scene that is not in the group") {
+        REQUIRE_THROWS_AS(group.remove(*source), std::invalid_argument);
+        REQUIRE(group.size() == 2);
+    }
+}